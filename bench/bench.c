@@ -0,0 +1,530 @@
+/*
+ * Microbenchmarks for xorlist.
+ *
+ * Every operation is timed against a plain doubly linked list and a dynamic
+ * array as baselines, across list sizes from 10 up to a maximum (10^7 by
+ * default). Results are written to stdout as CSV (the default) or JSON:
+ *
+ *     ./bench [max_size] [csv|json]
+ *
+ * Operations whose cost grows with the size of the list are repeated fewer
+ * times on larger lists so that each measurement takes roughly the same
+ * amount of work.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "alist.h"
+#include "list.h"
+
+/*
+ * The number of node visits an O(n) operation is allowed per measurement.
+ */
+#define WORK_BUDGET 20000000
+
+/*
+ * The most times any operation is repeated per measurement.
+ */
+#define MAX_REPEATS 100000
+
+/*
+ * Operations that add elements may always add at least this many, even to
+ * containers smaller than that.
+ */
+#define MIN_GROWTH 1000
+
+#define DEFAULT_MAX_SIZE 10000000
+
+/*
+ * The operations every implementation provides. Going through a function
+ * pointer costs the same for each of them.
+ */
+typedef struct {
+  const char *name;
+  void *(*create)(void);
+  void (*destroy)(void *);
+  void (*append)(void *, list_val_t);
+  void (*prepend)(void *, list_val_t);
+  void (*insert)(void *, size_t, list_val_t);
+  list_val_t (*get)(void *, size_t);
+  ssize_t (*find)(void *, list_val_t);
+  void (*remove)(void *, list_val_t);
+  void (*reverse)(void *);
+} impl_t;
+
+/******
+ * xorlist
+ ******/
+
+static void *xor_create(void) {
+  return list_create();
+}
+
+static void *xor_create_pool(void) {
+  return list_create_with_pool(0);
+}
+
+static void xor_destroy(void *list) {
+  list_destroy(list, nullptr);
+}
+
+static void xor_append(void *list, list_val_t value) {
+  list_append(list, value);
+}
+
+static void xor_prepend(void *list, list_val_t value) {
+  list_prepend(list, value);
+}
+
+static void xor_insert(void *list, size_t idx, list_val_t value) {
+  list_insert(list, idx, value);
+}
+
+static list_val_t xor_get(void *list, size_t idx) {
+  return list_get(*(list_t *)list, idx);
+}
+
+static ssize_t xor_find(void *list, list_val_t value) {
+  return list_find(*(list_t *)list, value);
+}
+
+static void xor_remove(void *list, list_val_t value) {
+  list_remove(list, value);
+}
+
+static void xor_reverse(void *list) {
+  list_reverse(list);
+}
+
+/******
+ * Arena xorlist, whose values are 32-bit handles
+ ******/
+
+static void *arena_create(void) {
+  return alist_create();
+}
+
+static void arena_destroy(void *list) {
+  alist_destroy(list, nullptr);
+}
+
+static void arena_append(void *list, list_val_t value) {
+  alist_append(list, (alist_val_t)(uintptr_t)value);
+}
+
+static void arena_prepend(void *list, list_val_t value) {
+  alist_prepend(list, (alist_val_t)(uintptr_t)value);
+}
+
+static void arena_insert(void *list, size_t idx, list_val_t value) {
+  alist_insert(list, idx, (alist_val_t)(uintptr_t)value);
+}
+
+static list_val_t arena_get(void *list, size_t idx) {
+  alist_val_t value = 0;
+  alist_get(*(alist_t *)list, idx, &value);
+  return (list_val_t)(uintptr_t)value;
+}
+
+static ssize_t arena_find(void *list, list_val_t value) {
+  return alist_find(*(alist_t *)list, (alist_val_t)(uintptr_t)value);
+}
+
+static void arena_remove(void *list, list_val_t value) {
+  alist_remove(list, (alist_val_t)(uintptr_t)value);
+}
+
+static void arena_reverse(void *list) {
+  alist_reverse(list);
+}
+
+/******
+ * Doubly linked list baseline
+ ******/
+
+typedef struct dnode {
+  struct dnode *prev;
+  struct dnode *next;
+  list_val_t value;
+} dnode_t;
+
+typedef struct {
+  dnode_t sentinel;
+  size_t size;
+} dlist_t;
+
+static void *dl_create(void) {
+  dlist_t *list = malloc(sizeof(dlist_t));
+  list->sentinel.prev = &list->sentinel;
+  list->sentinel.next = &list->sentinel;
+  list->size = 0;
+  return list;
+}
+
+static void dl_destroy(void *ptr) {
+  dlist_t *list = ptr;
+  dnode_t *node = list->sentinel.next;
+  while (node != &list->sentinel) {
+    dnode_t *next = node->next;
+    free(node);
+    node = next;
+  }
+  free(list);
+}
+
+static void dl_link(dlist_t *list, dnode_t *before, list_val_t value) {
+  dnode_t *node = malloc(sizeof(dnode_t));
+  node->value = value;
+  node->prev = before;
+  node->next = before->next;
+  before->next->prev = node;
+  before->next = node;
+  list->size += 1;
+}
+
+static dnode_t *dl_node(dlist_t *list, size_t idx) {
+  dnode_t *node;
+  if (idx <= list->size / 2) {
+    node = list->sentinel.next;
+    for (size_t i = 0; i < idx; i++) {
+      node = node->next;
+    }
+  } else {
+    node = &list->sentinel;
+    for (size_t i = idx; i < list->size; i++) {
+      node = node->prev;
+    }
+  }
+  return node;
+}
+
+static void dl_append(void *ptr, list_val_t value) {
+  dlist_t *list = ptr;
+  dl_link(list, list->sentinel.prev, value);
+}
+
+static void dl_prepend(void *ptr, list_val_t value) {
+  dlist_t *list = ptr;
+  dl_link(list, &list->sentinel, value);
+}
+
+static void dl_insert(void *ptr, size_t idx, list_val_t value) {
+  dlist_t *list = ptr;
+  dl_link(list, dl_node(list, idx)->prev, value);
+}
+
+static list_val_t dl_get(void *ptr, size_t idx) {
+  return dl_node(ptr, idx)->value;
+}
+
+static ssize_t dl_find(void *ptr, list_val_t value) {
+  dlist_t *list = ptr;
+  ssize_t idx = 0;
+  for (dnode_t *node = list->sentinel.next; node != &list->sentinel; node = node->next) {
+    if (node->value == value) {
+      return idx;
+    }
+    idx++;
+  }
+  return -1;
+}
+
+static void dl_remove(void *ptr, list_val_t value) {
+  dlist_t *list = ptr;
+  for (dnode_t *node = list->sentinel.next; node != &list->sentinel; node = node->next) {
+    if (node->value == value) {
+      node->prev->next = node->next;
+      node->next->prev = node->prev;
+      free(node);
+      list->size -= 1;
+      return;
+    }
+  }
+}
+
+static void dl_reverse(void *ptr) {
+  dlist_t *list = ptr;
+  dnode_t *node = &list->sentinel;
+  do {
+    dnode_t *next = node->next;
+    node->next = node->prev;
+    node->prev = next;
+    node = next;
+  } while (node != &list->sentinel);
+}
+
+/******
+ * Dynamic array baseline
+ ******/
+
+typedef struct {
+  list_val_t *values;
+  size_t size;
+  size_t capacity;
+} array_t;
+
+static void *arr_create(void) {
+  return calloc(1, sizeof(array_t));
+}
+
+static void arr_destroy(void *ptr) {
+  array_t *array = ptr;
+  free(array->values);
+  free(array);
+}
+
+static void arr_insert(void *ptr, size_t idx, list_val_t value) {
+  array_t *array = ptr;
+  if (array->size == array->capacity) {
+    array->capacity = array->capacity ? array->capacity * 2 : 8;
+    array->values = realloc(array->values, array->capacity * sizeof(list_val_t));
+  }
+  memmove(array->values + idx + 1, array->values + idx, (array->size - idx) * sizeof(list_val_t));
+  array->values[idx] = value;
+  array->size += 1;
+}
+
+static void arr_append(void *ptr, list_val_t value) {
+  arr_insert(ptr, ((array_t *)ptr)->size, value);
+}
+
+static void arr_prepend(void *ptr, list_val_t value) {
+  arr_insert(ptr, 0, value);
+}
+
+static list_val_t arr_get(void *ptr, size_t idx) {
+  return ((array_t *)ptr)->values[idx];
+}
+
+static ssize_t arr_find(void *ptr, list_val_t value) {
+  array_t *array = ptr;
+  for (size_t i = 0; i < array->size; i++) {
+    if (array->values[i] == value) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void arr_remove(void *ptr, list_val_t value) {
+  array_t *array = ptr;
+  ssize_t idx = arr_find(ptr, value);
+  if (idx >= 0) {
+    memmove(array->values + idx, array->values + idx + 1,
+            (array->size - idx - 1) * sizeof(list_val_t));
+    array->size -= 1;
+  }
+}
+
+static void arr_reverse(void *ptr) {
+  array_t *array = ptr;
+  for (size_t i = 0; i < array->size / 2; i++) {
+    list_val_t tmp = array->values[i];
+    array->values[i] = array->values[array->size - 1 - i];
+    array->values[array->size - 1 - i] = tmp;
+  }
+}
+
+static const impl_t impls[] = {
+    {"xorlist", xor_create, xor_destroy, xor_append, xor_prepend, xor_insert, xor_get, xor_find,
+     xor_remove, xor_reverse},
+    {"xorlist-pool", xor_create_pool, xor_destroy, xor_append, xor_prepend, xor_insert, xor_get,
+     xor_find, xor_remove, xor_reverse},
+    {"xorlist-arena", arena_create, arena_destroy, arena_append, arena_prepend, arena_insert,
+     arena_get, arena_find, arena_remove, arena_reverse},
+    {"dlist", dl_create, dl_destroy, dl_append, dl_prepend, dl_insert, dl_get, dl_find, dl_remove,
+     dl_reverse},
+    {"array", arr_create, arr_destroy, arr_append, arr_prepend, arr_insert, arr_get, arr_find,
+     arr_remove, arr_reverse},
+};
+
+/******
+ * Harness
+ ******/
+
+typedef enum { FORMAT_CSV, FORMAT_JSON } format_t;
+
+static format_t format = FORMAT_CSV;
+static bool first_result = true;
+
+/*
+ * Defeats dead code elimination of the values read back.
+ */
+static volatile uintptr_t sink;
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * The number of bytes currently allocated from the heap, or 0 if that can't
+ * be determined on this platform.
+ */
+static size_t heap_in_use(void) {
+#ifdef __GLIBC__
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+#else
+  return 0;
+#endif
+}
+
+/*
+ * A distinct, non-null value for each index.
+ */
+static list_val_t value_for(size_t i) {
+  return (list_val_t)(uintptr_t)(i + 1);
+}
+
+/*
+ * The number of times to repeat an operation that visits about `cost` nodes.
+ */
+static size_t repeats(size_t cost) {
+  size_t count = WORK_BUDGET / (cost ? cost : 1);
+  if (count < 1) {
+    return 1;
+  }
+  return count > MAX_REPEATS ? MAX_REPEATS : count;
+}
+
+/*
+ * Limits the number of operations that add to a container so that it grows
+ * by a bounded amount, keeping the measurement representative of its size.
+ */
+static size_t growth(size_t size, size_t ops) {
+  size_t limit = size > MIN_GROWTH ? size : MIN_GROWTH;
+  return ops > limit ? limit : ops;
+}
+
+static void report(const impl_t *impl, const char *op, size_t size, size_t ops, double elapsed,
+                   double bytes_per_element) {
+  double ns_per_op = elapsed / ops * 1e9;
+
+  if (format == FORMAT_JSON) {
+    printf("%s\n  {\"impl\": \"%s\", \"op\": \"%s\", \"size\": %zu, \"ops\": %zu, "
+           "\"ns_per_op\": %.2f, \"bytes_per_element\": %.2f}",
+           first_result ? "[" : ",", impl->name, op, size, ops, ns_per_op, bytes_per_element);
+  } else {
+    if (first_result) {
+      printf("impl,op,size,ops,ns_per_op,bytes_per_element\n");
+    }
+    printf("%s,%s,%zu,%zu,%.2f,%.2f\n", impl->name, op, size, ops, ns_per_op, bytes_per_element);
+  }
+
+  first_result = false;
+  fflush(stdout);
+}
+
+/*
+ * Builds a container of the given size by appending.
+ */
+static void *build(const impl_t *impl, size_t size) {
+  void *list = impl->create();
+  for (size_t i = 0; i < size; i++) {
+    impl->append(list, value_for(i));
+  }
+  return list;
+}
+
+static void bench_size(const impl_t *impl, size_t size) {
+  double start;
+
+  /* append, which also measures the memory used per element. */
+  size_t heap_before = heap_in_use();
+  start = now();
+  void *list = build(impl, size);
+  double elapsed = now() - start;
+  double bytes = (double)(heap_in_use() - heap_before) / size;
+  report(impl, "append", size, size, elapsed, bytes);
+
+  /* get */
+  size_t ops = repeats(size / 4);
+  start = now();
+  for (size_t i = 0; i < ops; i++) {
+    sink += (uintptr_t)impl->get(list, rand() % size);
+  }
+  report(impl, "get", size, ops, now() - start, bytes);
+
+  /* find */
+  ops = repeats(size / 2);
+  start = now();
+  for (size_t i = 0; i < ops; i++) {
+    sink += impl->find(list, value_for(rand() % size));
+  }
+  report(impl, "find", size, ops, now() - start, bytes);
+
+  /* reverse */
+  ops = repeats(size);
+  start = now();
+  for (size_t i = 0; i < ops; i++) {
+    impl->reverse(list);
+  }
+  report(impl, "reverse", size, ops, now() - start, bytes);
+  if (ops % 2) {
+    impl->reverse(list);
+  }
+
+  /* insert, then remove the same values again to restore the size. */
+  ops = growth(size, repeats(size / 2));
+  start = now();
+  for (size_t i = 0; i < ops; i++) {
+    impl->insert(list, rand() % size, value_for(size + i));
+  }
+  report(impl, "insert", size, ops, now() - start, bytes);
+
+  start = now();
+  for (size_t i = 0; i < ops; i++) {
+    impl->remove(list, value_for(size + i));
+  }
+  report(impl, "remove", size, ops, now() - start, bytes);
+
+  /* prepend */
+  ops = growth(size, repeats(size));
+  start = now();
+  for (size_t i = 0; i < ops; i++) {
+    impl->prepend(list, value_for(size + i));
+  }
+  report(impl, "prepend", size, ops, now() - start, bytes);
+
+  /* destroy */
+  start = now();
+  impl->destroy(list);
+  report(impl, "destroy", size, size + ops, now() - start, bytes);
+}
+
+int main(int argc, char **argv) {
+  size_t max_size = DEFAULT_MAX_SIZE;
+
+  if (argc > 1) {
+    max_size = strtoull(argv[1], nullptr, 10);
+  }
+  if (argc > 2 && strcmp(argv[2], "json") == 0) {
+    format = FORMAT_JSON;
+  }
+
+  srand(1);
+  for (size_t size = 10; size <= max_size; size *= 10) {
+    for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+      bench_size(&impls[i], size);
+    }
+  }
+
+  if (format == FORMAT_JSON) {
+    printf("\n]\n");
+  }
+
+  return EXIT_SUCCESS;
+}
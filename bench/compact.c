@@ -0,0 +1,86 @@
+/*
+ * Compares full scans of a list before and after list_compact at several
+ * levels of fragmentation.
+ *
+ * The nodes are allocated in address order and then sorted by a key in
+ * which a given share of the elements have been swapped at random, so that
+ * share of the steps in a traversal jump somewhere else in memory.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "list.h"
+
+#define COUNT 1000000
+#define SCANS 10
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int compare_keys(list_val_t a, list_val_t b) {
+  uintptr_t x = (uintptr_t)a;
+  uintptr_t y = (uintptr_t)b;
+  return (x > y) - (x < y);
+}
+
+static list_t *fragmented(int percent) {
+  uintptr_t *keys = malloc(COUNT * sizeof(uintptr_t));
+  for (size_t i = 0; i < COUNT; i++) {
+    keys[i] = i + 1;
+  }
+  for (size_t i = 0; i < COUNT / 200 * percent; i++) {
+    size_t a = rand() % COUNT;
+    size_t b = rand() % COUNT;
+    uintptr_t tmp = keys[a];
+    keys[a] = keys[b];
+    keys[b] = tmp;
+  }
+
+  list_t *list = list_create_with_pool(COUNT);
+  for (size_t i = 0; i < COUNT; i++) {
+    list_append(list, (list_val_t)keys[i]);
+  }
+  list_sort(list, compare_keys);
+
+  free(keys);
+  return list;
+}
+
+/* Looks for a value that isn't there, which walks the whole list. */
+static double scan(list_t *list) {
+  double start = now();
+  for (int i = 0; i < SCANS; i++) {
+    list_find(*list, nullptr);
+  }
+  return (now() - start) / SCANS / COUNT * 1e9;
+}
+
+int main(void) {
+  static const int levels[] = {0, 1, 10, 50, 100};
+
+  srand(42);
+  printf("fragmentation,before_ns_per_node,after_ns_per_node,compact_ms\n");
+  for (size_t i = 0; i < sizeof(levels) / sizeof(levels[0]); i++) {
+    list_t *list = fragmented(levels[i]);
+    double before = scan(list);
+
+    double start = now();
+    list_compact(list);
+    double compact = now() - start;
+
+    double after = scan(list);
+    printf("%d%%,%.2f,%.2f,%.2f\n", levels[i], before, after, compact * 1e3);
+    list_destroy(list, nullptr);
+  }
+
+  return EXIT_SUCCESS;
+}
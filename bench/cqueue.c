@@ -0,0 +1,177 @@
+/*
+ * Compares the throughput of the concurrent queue against a list_t guarded
+ * by a single mutex, with an equal number of producer and consumer threads.
+ *
+ *     ./cqueue [max_threads]
+ *
+ * The thread count doubles from 2 up to the maximum (twice the number of
+ * online CPUs by default). Results are written to stdout as CSV.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cqueue.h"
+#include "list.h"
+
+#define ITEMS 4000000
+#define BATCH 16
+
+/*
+ * The operations every queue provides.
+ */
+typedef struct {
+  const char *name;
+  void *(*create)(void);
+  void (*destroy)(void *);
+  void (*enqueue)(void *, list_val_t);
+  size_t (*dequeue_n)(void *, list_val_t *, size_t);
+} impl_t;
+
+typedef struct {
+  list_t *list;
+  pthread_mutex_t lock;
+} locked_list_t;
+
+static void *locked_create(void) {
+  locked_list_t *queue = malloc(sizeof(locked_list_t));
+  queue->list = list_create();
+  pthread_mutex_init(&queue->lock, nullptr);
+  return queue;
+}
+
+static void locked_destroy(void *queue) {
+  locked_list_t *locked = queue;
+  list_destroy(locked->list, nullptr);
+  pthread_mutex_destroy(&locked->lock);
+  free(locked);
+}
+
+static void locked_enqueue(void *queue, list_val_t value) {
+  locked_list_t *locked = queue;
+  pthread_mutex_lock(&locked->lock);
+  list_enqueue(locked->list, value);
+  pthread_mutex_unlock(&locked->lock);
+}
+
+static size_t locked_dequeue_n(void *queue, list_val_t *values, size_t max) {
+  locked_list_t *locked = queue;
+  size_t count = 0;
+  pthread_mutex_lock(&locked->lock);
+  while (count < max && !list_is_empty(*locked->list)) {
+    values[count++] = list_dequeue(locked->list);
+  }
+  pthread_mutex_unlock(&locked->lock);
+  return count;
+}
+
+static void *cq_create(void) {
+  return cqueue_create();
+}
+
+static void cq_destroy(void *queue) {
+  cqueue_destroy(queue, nullptr);
+}
+
+static void cq_enqueue(void *queue, list_val_t value) {
+  cqueue_enqueue(queue, value);
+}
+
+static size_t cq_dequeue_n(void *queue, list_val_t *values, size_t max) {
+  return cqueue_dequeue_n(queue, values, max);
+}
+
+static const impl_t impls[] = {
+    {"mutex+list", locked_create, locked_destroy, locked_enqueue, locked_dequeue_n},
+    {"cqueue", cq_create, cq_destroy, cq_enqueue, cq_dequeue_n},
+};
+
+typedef struct {
+  const impl_t *impl;
+  void *queue;
+  size_t items;
+  size_t batch;
+  atomic_size_t *remaining;
+} worker_t;
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *produce(void *arg) {
+  worker_t *worker = arg;
+  for (size_t i = 0; i < worker->items; i++) {
+    worker->impl->enqueue(worker->queue, (list_val_t)(uintptr_t)(i + 1));
+  }
+  return nullptr;
+}
+
+static void *consume(void *arg) {
+  worker_t *worker = arg;
+  list_val_t values[BATCH];
+  while (atomic_load(worker->remaining) > 0) {
+    size_t count = worker->impl->dequeue_n(worker->queue, values, worker->batch);
+    atomic_fetch_sub(worker->remaining, count);
+  }
+  return nullptr;
+}
+
+/*
+ * Pushes ITEMS items through the queue with threads / 2 producers and as
+ * many consumers, returning the time per item.
+ */
+static double run(const impl_t *impl, size_t threads, size_t batch) {
+  size_t pairs = threads / 2;
+  size_t items = ITEMS / pairs;
+  atomic_size_t remaining = items * pairs;
+  pthread_t *ids = malloc(threads * sizeof(pthread_t));
+  worker_t worker = {
+      .impl = impl,
+      .queue = impl->create(),
+      .items = items,
+      .batch = batch,
+      .remaining = &remaining,
+  };
+
+  double start = now();
+  for (size_t i = 0; i < threads; i++) {
+    pthread_create(&ids[i], nullptr, i < pairs ? produce : consume, &worker);
+  }
+  for (size_t i = 0; i < threads; i++) {
+    pthread_join(ids[i], nullptr);
+  }
+  double elapsed = now() - start;
+
+  impl->destroy(worker.queue);
+  free(ids);
+  return elapsed / (items * pairs) * 1e9;
+}
+
+int main(int argc, char **argv) {
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  size_t max_threads = argc > 1 ? strtoull(argv[1], nullptr, 10) : 2 * (cpus > 0 ? cpus : 1);
+  if (max_threads < 2) {
+    max_threads = 2;
+  }
+
+  printf("impl,threads,batch,ns_per_item\n");
+  for (size_t threads = 2; threads <= max_threads; threads *= 2) {
+    for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+      printf("%s,%zu,1,%.2f\n", impls[i].name, threads, run(&impls[i], threads, 1));
+      printf("%s,%zu,%d,%.2f\n", impls[i].name, threads, BATCH, run(&impls[i], threads, BATCH));
+      fflush(stdout);
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,65 @@
+/*
+ * Measures how long tearing down a large list blocks the caller: popping
+ * every element, list_destroy, and list_destroy_async (along with how long
+ * the reclaimer takes to finish in the background).
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "list.h"
+
+#define COUNT 10000000
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static list_t *build(bool pooled) {
+  list_t *list = pooled ? list_create_with_pool(0) : list_create();
+  for (size_t i = 0; i < COUNT; i++) {
+    list_append(list, malloc(sizeof(int)));
+  }
+  return list;
+}
+
+static void report(const char *method, bool pooled, double blocked, double total) {
+  printf("%s,%s,%.4f,%.4f\n", method, pooled ? "pool" : "malloc", blocked, total);
+}
+
+int main(void) {
+  printf("method,nodes,blocked_seconds,total_seconds\n");
+  for (int pooled = 0; pooled <= 1; pooled++) {
+    list_t *list = build(pooled);
+    double start = now();
+    while (!list_is_empty(*list)) {
+      free(list_pop(list));
+    }
+    list_destroy(list, nullptr);
+    double elapsed = now() - start;
+    report("pop", pooled, elapsed, elapsed);
+
+    list = build(pooled);
+    start = now();
+    list_destroy(list, free);
+    elapsed = now() - start;
+    report("destroy", pooled, elapsed, elapsed);
+
+    list = build(pooled);
+    start = now();
+    list_destroy_async(list, free);
+    double blocked = now() - start;
+    list_destroy_async_wait();
+    report("destroy_async", pooled, blocked, now() - start);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,62 @@
+/*
+ * Measures how list_reduce_parallel scales with the number of threads on
+ * CPU-heavy per-element work.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "list.h"
+#include "parallel.h"
+
+#define COUNT 2000000
+#define MAX_THREADS 16
+#define WORK 200
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* A few hundred rounds of an integer hash stand in for real work. */
+static void reduce(void *acc, list_val_t value, void *ctx) {
+  uint64_t x = (uintptr_t)value;
+  for (int i = 0; i < WORK; i++) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+  }
+  *(uint64_t *)acc += x;
+}
+
+static void combine(void *acc, const void *other, void *ctx) {
+  *(uint64_t *)acc += *(const uint64_t *)other;
+}
+
+int main(void) {
+  list_t *list = list_create_with_pool(0);
+  for (uintptr_t i = 0; i < COUNT; i++) {
+    list_append(list, (list_val_t)i);
+  }
+
+  printf("threads,seconds,speedup\n");
+  double base = 0;
+  for (size_t threads = 1; threads <= MAX_THREADS; threads *= 2) {
+    uint64_t result = 0;
+    double start = now();
+    list_reduce_parallel(list, threads, &result, sizeof(result), reduce, combine, nullptr);
+    double elapsed = now() - start;
+    if (threads == 1) {
+      base = elapsed;
+    }
+    printf("%zu,%.4f,%.2f\n", threads, elapsed, base / elapsed);
+  }
+
+  list_destroy(list, nullptr);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+/*
+ * Compares the startup cost of rebuilding a large list against loading it
+ * from a saved image and mapping the image in place.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "list.h"
+#include "persist.h"
+
+#define COUNT 10000000
+#define IMAGE "persist.img"
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static list_t *rebuild(void) {
+  list_t *list = list_create_inline(sizeof(uint64_t));
+  for (uint64_t i = 0; i < COUNT; i++) {
+    list_append(list, &i);
+  }
+  return list;
+}
+
+int main(void) {
+  double start = now();
+  list_t *list = rebuild();
+  double built = now() - start;
+
+  if (list_save(list, IMAGE)) {
+    fprintf(stderr, "could not write %s\n", IMAGE);
+    return EXIT_FAILURE;
+  }
+  list_destroy(list, nullptr);
+
+  start = now();
+  list = list_load(IMAGE);
+  double loaded = now() - start;
+  list_destroy(list, nullptr);
+
+  list_view_t view;
+  start = now();
+  list_view_open(&view, IMAGE);
+  double mapped = now() - start;
+
+  /* Touch the last element so the comparison includes finding something. */
+  uint64_t last = COUNT - 1;
+  start = now();
+  ssize_t idx = list_view_find(view, &last);
+  double found = now() - start;
+  list_view_close(&view);
+  unlink(IMAGE);
+
+  printf("startup with %d elements\n", COUNT);
+  printf("  rebuild:   %10.2f ms\n", built * 1e3);
+  printf("  list_load: %10.2f ms\n", loaded * 1e3);
+  printf("  view:      %10.2f ms (full scan to %zd: %.2f ms)\n", mapped * 1e3, idx, found * 1e3);
+
+  return EXIT_SUCCESS;
+}
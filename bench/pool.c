@@ -0,0 +1,53 @@
+/*
+ * Compares queue throughput of a heap-backed list against a pool-backed
+ * list.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "list.h"
+
+#define DEPTH 64
+#define ROUNDS 10000000
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * Keeps the queue at a constant depth while pushing ROUNDS items through it,
+ * which is the steady state the pool is meant for.
+ */
+static double churn(list_t *list) {
+  for (size_t i = 0; i < DEPTH; i++) {
+    list_enqueue(list, list);
+  }
+
+  double start = now();
+  for (size_t i = 0; i < ROUNDS; i++) {
+    list_enqueue(list, list);
+    list_dequeue(list);
+  }
+  double elapsed = now() - start;
+
+  list_destroy(list, nullptr);
+  return elapsed;
+}
+
+int main(void) {
+  double heap = churn(list_create());
+  double pool = churn(list_create_with_pool(0));
+
+  printf("enqueue/dequeue x %d (depth %d)\n", ROUNDS, DEPTH);
+  printf("  malloc: %8.2f ns/op\n", heap / ROUNDS * 1e9);
+  printf("  pool:   %8.2f ns/op (%.2fx)\n", pool / ROUNDS * 1e9, heap / pool);
+
+  return EXIT_SUCCESS;
+}
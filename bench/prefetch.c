@@ -0,0 +1,122 @@
+/*
+ * Compares comparator-based searches of a list too large for the cache with
+ * and without prefetching the values ahead of the comparisons.
+ *
+ * The values are allocated separately and linked in a random order. The
+ * nodes are either contiguous or scattered as well. The plain search walks
+ * the list with a cursor and calls the comparator on each element;
+ * list_find_by does the same while prefetching the values ahead. Build with
+ * -DXORLIST_PREFETCH_DISTANCE=n to try other distances.
+ *
+ * list_find is timed as well for reference. It compares the pointers
+ * themselves, so there are no values to prefetch and it is bound by the walk
+ * from node to node alone.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "list.h"
+
+#define COUNT 4000000
+#define SCANS 5
+
+typedef struct record {
+  uint64_t key;
+  char payload[56];
+} record_t;
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int compare_records(list_val_t a, list_val_t b) {
+  uint64_t x = ((record_t *)a)->key;
+  uint64_t y = ((record_t *)b)->key;
+  return (x > y) - (x < y);
+}
+
+static int compare_order(list_val_t a, list_val_t b) {
+  uint64_t x = *(uint64_t *)((record_t *)a)->payload;
+  uint64_t y = *(uint64_t *)((record_t *)b)->payload;
+  return (x > y) - (x < y);
+}
+
+static ssize_t plain_find(list_t *list, list_val_t key) {
+  list_cursor_t cursor = list_cursor_begin(list);
+  for (; list_cursor_valid(cursor); list_cursor_next(&cursor)) {
+    if (compare_records(list_cursor_get(cursor), key) == 0) {
+      return cursor.idx;
+    }
+  }
+  return -1;
+}
+
+static void run(const char *name, list_t *list) {
+  record_t missing = {.key = UINT64_MAX};
+  double start = now();
+  for (int i = 0; i < SCANS; i++) {
+    plain_find(list, &missing);
+  }
+  double plain = (now() - start) / SCANS;
+
+  start = now();
+  for (int i = 0; i < SCANS; i++) {
+    list_find_by(*list, &missing, compare_records);
+  }
+  double prefetched = (now() - start) / SCANS;
+
+  start = now();
+  for (int i = 0; i < SCANS; i++) {
+    list_find(*list, &missing);
+  }
+  double find = (now() - start) / SCANS;
+
+  printf("%s,%.2f,%.2f,%.2f,%.2f\n", name, plain / COUNT * 1e9, prefetched / COUNT * 1e9,
+         plain / prefetched, find / COUNT * 1e9);
+}
+
+int main(void) {
+  record_t **records = malloc(COUNT * sizeof(record_t *));
+  srand(7);
+  for (size_t i = 0; i < COUNT; i++) {
+    records[i] = malloc(sizeof(record_t));
+    records[i]->key = i;
+    *(uint64_t *)records[i]->payload = ((uint64_t)rand() << 31) ^ rand();
+  }
+  /* Keep the values away from the nodes, and out of order with them. */
+  for (size_t i = COUNT; i > 1; i--) {
+    size_t j = rand() % i;
+    record_t *tmp = records[i - 1];
+    records[i - 1] = records[j];
+    records[j] = tmp;
+  }
+
+  printf("nodes,plain_ns_per_element,find_by_ns_per_element,speedup,find_ns_per_element\n");
+
+  /* Nodes in one block, as after list_compact. */
+  list_t *list = list_create_with_pool(COUNT);
+  list_extend(list, (list_val_t *)records, COUNT);
+  run("contiguous", list);
+  list_destroy(list, nullptr);
+
+  /* Nodes relinked in a random order. */
+  list = list_create();
+  list_extend(list, (list_val_t *)records, COUNT);
+  list_sort(list, compare_order);
+  run("scattered", list);
+  list_destroy(list, nullptr);
+
+  for (size_t i = 0; i < COUNT; i++) {
+    free(records[i]);
+  }
+  free(records);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+/*
+ * Measures how long a writer stalls while readers scan a list, comparing
+ * published snapshots against a list guarded by a mutex.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "list.h"
+#include "snapshot.h"
+
+#define SIZE 100000
+#define SECONDS 0.5
+#define BATCH 10000
+#define MAX_READERS 4
+
+typedef struct
+{
+  list_t *list;
+  list_publisher_t *pub;
+  pthread_mutex_t lock;
+  atomic_bool done;
+  atomic_size_t scans;
+} shared_t;
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uintptr_t scan(list_t *list) {
+  uintptr_t sum = 0;
+  for (list_cursor_t cursor = list_cursor_begin(list); list_cursor_valid(cursor);
+       list_cursor_next(&cursor)) {
+    sum += (uintptr_t)list_cursor_get(cursor);
+  }
+  return sum;
+}
+
+static void *snapshot_reader(void *arg) {
+  shared_t *shared = arg;
+  ssize_t id = list_reader_register(shared->pub);
+  volatile uintptr_t sink = 0;
+  while (!atomic_load(&shared->done)) {
+    sink += scan(list_snapshot(shared->pub, id));
+    list_snapshot_release(shared->pub, id);
+    atomic_fetch_add(&shared->scans, 1);
+  }
+  list_reader_unregister(shared->pub, id);
+  return nullptr;
+}
+
+static void *locked_reader(void *arg) {
+  shared_t *shared = arg;
+  volatile uintptr_t sink = 0;
+  while (!atomic_load(&shared->done)) {
+    pthread_mutex_lock(&shared->lock);
+    sink += scan(shared->list);
+    pthread_mutex_unlock(&shared->lock);
+    atomic_fetch_add(&shared->scans, 1);
+  }
+  return nullptr;
+}
+
+/*
+ * Slides a window over the numbers for a while, timing the longest single
+ * update. Publishing is timed separately since it only happens every BATCH
+ * updates.
+ */
+static void run(const char *mode, size_t readers, bool snapshots) {
+  shared_t shared = {.list = list_create_with_pool(0)};
+  pthread_mutex_init(&shared.lock, nullptr);
+  atomic_init(&shared.done, false);
+  atomic_init(&shared.scans, 0);
+  for (uintptr_t i = 0; i < SIZE; i++) {
+    list_append(shared.list, (list_val_t)i);
+  }
+  if (snapshots) {
+    shared.pub = list_publisher_create();
+    list_publish(shared.pub, shared.list);
+  }
+
+  pthread_t threads[MAX_READERS];
+  for (size_t i = 0; i < readers; i++) {
+    pthread_create(&threads[i], nullptr, snapshots ? snapshot_reader : locked_reader, &shared);
+  }
+
+  double worst = 0;
+  double publishing = 0;
+  size_t publishes = 0;
+  uintptr_t next = SIZE;
+  double end = now() + SECONDS;
+  while (now() < end) {
+    double before = now();
+    if (!snapshots) {
+      pthread_mutex_lock(&shared.lock);
+    }
+    list_append(shared.list, (list_val_t)next++);
+    list_pop(shared.list);
+    if (!snapshots) {
+      pthread_mutex_unlock(&shared.lock);
+    }
+    double took = now() - before;
+    worst = took > worst ? took : worst;
+
+    if (snapshots && next % BATCH == 0) {
+      before = now();
+      list_publish(shared.pub, shared.list);
+      publishing += now() - before;
+      publishes++;
+    }
+  }
+
+  atomic_store(&shared.done, true);
+  for (size_t i = 0; i < readers; i++) {
+    pthread_join(threads[i], nullptr);
+  }
+
+  printf("%s,%zu,%zu,%.1f,%.1f,%zu\n", mode, readers, (size_t)(next - SIZE), worst * 1e6,
+         publishes ? publishing / publishes * 1e6 : 0.0, atomic_load(&shared.scans));
+
+  if (snapshots) {
+    list_publisher_destroy(shared.pub);
+  }
+  pthread_mutex_destroy(&shared.lock);
+  list_destroy(shared.list, nullptr);
+}
+
+int main(void) {
+  printf("mode,readers,updates,worst_update_us,publish_us,scans\n");
+  for (size_t readers = 1; readers <= MAX_READERS; readers *= 2) {
+    run("mutex", readers, false);
+    run("snapshot", readers, true);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file alist.h
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef __ALIST_H
+#define __ALIST_H
+/*
+ * Header file for the arena-backed variant of xorlist.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+/**
+ * @brief A value stored in an arena list
+ *
+ * This is a 32-bit handle rather than a pointer, such as an index into a
+ * table owned by the caller.
+ */
+typedef uint32_t alist_val_t;
+
+/**
+ * @brief A function to tear down the values of an arena list
+ */
+typedef void (*alist_destructor)(alist_val_t);
+
+/**
+ * @brief A node in an arena list
+ *
+ * This is an opaque type. Every node is 8 bytes: the XOR of the arena
+ * indices of its neighbors and a \ref alist_val_t.
+ */
+typedef struct anode anode_t;
+
+/**
+ * @brief The arena-backed XOR Linked List
+ *
+ * This behaves like a \ref list_t of 32-bit handles, but the nodes live in
+ * one growable array (the arena) and are linked by the XOR of their indices
+ * in it rather than their addresses. Each element costs 8 bytes with no
+ * per-node allocation, and removed nodes are reused before the arena grows.
+ * A list holds fewer than `UINT32_MAX` elements.
+ */
+typedef struct
+{
+    /**
+     * The arena holding every node. Index 0 is never used, so that it can
+     * stand for "no node" in the links.
+     */
+    anode_t *nodes;
+    /**
+     * The number of nodes the arena has room for.
+     */
+    uint32_t capacity;
+    /**
+     * The number of nodes of the arena that have ever been handed out.
+     */
+    uint32_t used;
+    /**
+     * The first of the removed nodes waiting to be reused (or 0).
+     */
+    uint32_t free;
+    /**
+     * The index of the head of the list. This node never holds a value.
+     */
+    uint32_t head;
+    /**
+     * The index of the tail of the list. This node never holds a value.
+     */
+    uint32_t tail;
+    /**
+     * The number of elements stored in the list.
+     */
+    size_t size;
+} alist_t;
+
+/* Exported arena list functions */
+alist_t *alist_create(void);
+void alist_destroy(alist_t *, alist_destructor);
+int alist_reserve(alist_t *, size_t);
+int alist_insert(alist_t *, size_t, alist_val_t);
+int alist_append(alist_t *, alist_val_t);
+int alist_enqueue(alist_t *, alist_val_t);
+int alist_prepend(alist_t *, alist_val_t);
+int alist_push(alist_t *, alist_val_t);
+bool alist_is_empty(alist_t);
+int alist_delete(alist_t *, size_t, alist_val_t *);
+ssize_t alist_remove(alist_t *, alist_val_t);
+int alist_pop(alist_t *, alist_val_t *);
+int alist_dequeue(alist_t *, alist_val_t *);
+int alist_get(alist_t, size_t, alist_val_t *);
+int alist_peek(alist_t, alist_val_t *);
+int alist_set(alist_t *, size_t, alist_val_t);
+size_t alist_size(alist_t);
+ssize_t alist_find(alist_t, alist_val_t);
+bool alist_contains(alist_t, alist_val_t);
+void alist_reverse(alist_t *);
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file bqueue.h
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef __BQUEUE_H
+#define __BQUEUE_H
+/*
+ * Header file for the bounded blocking queue built on xorlist.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+#include "list.h"
+
+/**
+ * Passed as a timeout to wait for as long as it takes.
+ */
+#define BQUEUE_FOREVER (-1L)
+
+/**
+ * @brief A bounded queue for handing items between threads
+ *
+ * Producers block while the queue is full and consumers block while it is
+ * empty, sleeping on a condition variable rather than spinning. Every
+ * blocking call takes a timeout in milliseconds: \ref BQUEUE_FOREVER waits
+ * indefinitely and 0 doesn't wait at all.
+ *
+ * The items are kept in a pooled \ref list_t, so once the queue has been
+ * full its nodes are recycled without allocating.
+ */
+typedef struct
+{
+    /**
+     * The items in the queue, from the oldest to the newest.
+     */
+    list_t *list;
+    /**
+     * The largest number of items the queue holds.
+     */
+    size_t capacity;
+    /**
+     * Whether bqueue_close(bqueue_t *) has been called.
+     */
+    bool closed;
+    /**
+     * Guards every other member.
+     */
+    pthread_mutex_t lock;
+    /**
+     * Signalled when items are added.
+     */
+    pthread_cond_t not_empty;
+    /**
+     * Signalled when items are removed.
+     */
+    pthread_cond_t not_full;
+} bqueue_t;
+
+/* Exported blocking queue functions */
+bqueue_t *bqueue_create(size_t);
+void bqueue_destroy(bqueue_t *, element_destructor);
+int bqueue_enqueue(bqueue_t *, list_val_t, long);
+list_val_t bqueue_dequeue(bqueue_t *, long);
+size_t bqueue_dequeue_n(bqueue_t *, list_val_t *, size_t, long);
+void bqueue_close(bqueue_t *);
+size_t bqueue_size(bqueue_t *);
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file cqueue.h
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef __CQUEUE_H
+#define __CQUEUE_H
+/*
+ * Header file for the concurrent queue built on xorlist nodes.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+#include "list.h"
+
+/**
+ * The size of a cache line, used to keep the two ends of a \ref cqueue_t
+ * from sharing one.
+ */
+#define CQUEUE_CACHE_LINE 64
+
+/**
+ * @brief A queue that any number of threads can use at once
+ *
+ * The items are kept in an XOR Linked List, just like a \ref list_t used as
+ * a queue. Consumers only touch the head and the first couple of nodes, and
+ * producers only touch the tail and the last node, so each end has its own
+ * lock and the two only contend when the queue is nearly empty. Each end is
+ * kept on its own cache line.
+ *
+ * A cqueue_t must not be moved or copied once it has been created.
+ */
+typedef struct
+{
+    /**
+     * Held by consumers.
+     */
+    alignas(CQUEUE_CACHE_LINE) pthread_mutex_t head_lock;
+    /**
+     * The head of the queue, which items are dequeued after. This does not
+     * have a value associated with it.
+     */
+    node_t head;
+    /**
+     * Held by producers, and by consumers when the queue is nearly empty.
+     */
+    alignas(CQUEUE_CACHE_LINE) pthread_mutex_t tail_lock;
+    /**
+     * The tail of the queue, which items are enqueued before. This does not
+     * have a value associated with it.
+     */
+    node_t tail;
+    /**
+     * The number of items in the queue.
+     */
+    alignas(CQUEUE_CACHE_LINE) atomic_size_t size;
+} cqueue_t;
+
+/* Exported concurrent queue functions */
+cqueue_t *cqueue_create(void);
+void cqueue_destroy(cqueue_t *, element_destructor);
+int cqueue_enqueue(cqueue_t *, list_val_t);
+int cqueue_enqueue_n(cqueue_t *, const list_val_t *, size_t);
+list_val_t cqueue_dequeue(cqueue_t *);
+size_t cqueue_dequeue_n(cqueue_t *, list_val_t *, size_t);
+size_t cqueue_size(cqueue_t *);
+bool cqueue_is_empty(cqueue_t *);
+
+#endif
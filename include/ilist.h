@@ -0,0 +1,100 @@
+/**
+ * @file ilist.h
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef __ILIST_H
+#define __ILIST_H
+/*
+ * Header file for the intrusive variant of xorlist.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+/**
+ * @brief The link embedded in each element of an intrusive list
+ *
+ * An element can be in as many intrusive lists at once as it has xor_link_t
+ * members, but only in one list per member.
+ */
+typedef struct xor_link {
+    struct xor_link *link;
+} xor_link_t;
+
+/**
+ * @brief Get the struct an xor_link_t is embedded in
+ *
+ * @param ptr A pointer to the xor_link_t
+ * @param type The type of the containing struct
+ * @param member The name of the xor_link_t member within `type`
+ */
+#define ilist_entry(ptr, type, member) ((type *)((char *)(ptr) - offsetof(type, member)))
+
+/**
+ * @brief The intrusive XOR Linked List
+ *
+ * This behaves like a \ref list_t, except that the nodes are xor_link_t
+ * members of the caller's own structs, so the list never allocates: adding
+ * an element links in its xor_link_t and removing it unlinks it, leaving
+ * the element's memory entirely to the caller. Elements are identified by
+ * the address of their xor_link_t.
+ *
+ * An ilist_t must not be moved or copied (other than to pass it to a
+ * function that takes an ilist_t by value) once it has been initialized.
+ */
+typedef struct
+{
+    /**
+     * The head of the list, which is not an element.
+     */
+    xor_link_t *head;
+    /**
+     * The tail of the list, which is not an element.
+     */
+    xor_link_t *tail;
+    /**
+     * The number of elements in the list.
+     */
+    size_t size;
+    /**
+     * The storage for the head and tail. Use \ref head and \ref tail rather
+     * than these, as ilist_reverse(ilist_t *) swaps which is which.
+     */
+    xor_link_t ends[2];
+} ilist_t;
+
+/**
+ * @brief A function to release elements of an intrusive list
+ *
+ * This is passed the xor_link_t of each element, which ilist_entry can
+ * turn back into the element.
+ */
+typedef void (*ilist_release)(xor_link_t *);
+
+/* Exported intrusive list functions */
+void ilist_init(ilist_t *);
+void ilist_clear(ilist_t *, ilist_release);
+int ilist_insert(ilist_t *, size_t, xor_link_t *);
+int ilist_append(ilist_t *, xor_link_t *);
+int ilist_enqueue(ilist_t *, xor_link_t *);
+int ilist_prepend(ilist_t *, xor_link_t *);
+int ilist_push(ilist_t *, xor_link_t *);
+bool ilist_is_empty(ilist_t);
+xor_link_t *ilist_delete(ilist_t *, size_t);
+ssize_t ilist_remove(ilist_t *, xor_link_t *);
+xor_link_t *ilist_pop(ilist_t *);
+xor_link_t *ilist_dequeue(ilist_t *);
+xor_link_t *ilist_get(ilist_t, size_t);
+xor_link_t *ilist_peek(ilist_t);
+size_t ilist_size(ilist_t);
+ssize_t ilist_find(ilist_t, xor_link_t *);
+bool ilist_contains(ilist_t, xor_link_t *);
+void ilist_reverse(ilist_t *);
+
+#endif
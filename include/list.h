@@ -27,16 +27,118 @@ typedef void *list_val_t;
 /**
  * @brief A node in the list
  *
- * This is an opaque type. Other than the head and tail of the list, it should
- * be very difficult to a reference to a node_t.
+ * This should be treated as an opaque type; its layout is only visible so
+ * that the head and tail can be stored inside a \ref list_t. Other than the
+ * head and tail of the list, it should be very difficult to a reference to a
+ * node_t.
  */
-typedef struct node node_t;
+typedef struct node {
+    struct node *link;
+    list_val_t value;
+} node_t;
+
+/**
+ * @brief A slab allocator for list nodes
+ *
+ * This is an opaque type. A pool hands out nodes from large slabs and keeps
+ * removed nodes on a freelist so they can be reused without going back to
+ * `malloc(size_t)`.
+ */
+typedef struct list_pool list_pool_t;
+
+/**
+ * @brief A sparse index of positions in a list
+ *
+ * This is an opaque type. See list_anchors_enable(list_t *, size_t).
+ */
+typedef struct list_anchors list_anchors_t;
+
+/**
+ * @brief A hash index from values to the nodes holding them
+ *
+ * This is an opaque type. See list_hash_enable(list_t *).
+ */
+typedef struct list_hash list_hash_t;
+
+/**
+ * Walks along the list of more than this many steps are counted as long in
+ * \ref list_stats.
+ */
+#ifndef XORLIST_STATS_LONG_WALK
+#define XORLIST_STATS_LONG_WALK 64
+#endif
+
+/**
+ * How many nodes searches run ahead of the node being compared, prefetching
+ * each one's value as it is found. Set this to 0 (wherever xorlist is built)
+ * to turn prefetching off.
+ */
+#ifndef XORLIST_PREFETCH_DISTANCE
+#define XORLIST_PREFETCH_DISTANCE 16
+#endif
+
+/**
+ * @brief Statistics about how a list has been used
+ *
+ * These are only gathered when xorlist is built with `XORLIST_STATS`
+ * defined. See list_stats(list_t *, struct list_stats *).
+ */
+struct list_stats
+{
+    /**
+     * The number of elements added to the list.
+     */
+    size_t inserts;
+    /**
+     * The number of elements removed from the list.
+     */
+    size_t removes;
+    /**
+     * The number of times the list was walked to reach an index.
+     */
+    size_t lookups;
+    /**
+     * The number of times the list was walked to look for a value.
+     */
+    size_t searches;
+    /**
+     * The total number of steps taken by lookups and searches.
+     */
+    size_t steps;
+    /**
+     * The most steps taken by a single lookup or search.
+     */
+    size_t max_steps;
+    /**
+     * The number of lookups and searches that took more than
+     * \ref XORLIST_STATS_LONG_WALK steps, which is where quadratic access
+     * patterns show up.
+     */
+    size_t long_walks;
+    /**
+     * The number of heap allocations made for nodes (or slabs of them).
+     */
+    size_t allocs;
+    /**
+     * The number of nodes returned to the heap.
+     */
+    size_t frees;
+    /**
+     * The number of heap bytes held by the list's nodes, pool and indexes.
+     */
+    size_t bytes;
+};
 
 /**
  * @brief The XOR Linked List
  *
  * The list tracks a head, a tail, and the size of the list. The head and tail
  * will remain "static" for the life of the list.
+ *
+ * Because the first and last nodes are linked to the head and tail, which
+ * are stored inside the list_t itself, a list_t must not be moved or copied
+ * (other than to pass it to a function that takes a list_t by value) once it
+ * has been initialized.
  */
 typedef struct
 {
@@ -54,8 +156,87 @@ typedef struct
      * The number of elements stored in the list.
      */
     size_t size;
+    /**
+     * The size of each element stored inline in the nodes, or 0 when the
+     * nodes store \ref list_val_t pointers. See list_create_inline(size_t).
+     */
+    size_t elem_size;
+    /**
+     * The pool nodes are allocated from, or `nullptr` when each node is
+     * allocated with `malloc(size_t)`.
+     */
+    list_pool_t *pool;
+    /**
+     * The anchors used to speed up positional access, or `nullptr` when
+     * they are disabled.
+     */
+    list_anchors_t *anchors;
+    /**
+     * The hash index used to find nodes by value, or `nullptr` when it is
+     * disabled.
+     */
+    list_hash_t *hash;
+    /**
+     * The number of nodes removed since the list was last compacted.
+     */
+    size_t churn;
+    /**
+     * How many removals trigger an automatic compaction, or 0 to never
+     * compact automatically. See list_compact_auto(list_t *, size_t).
+     */
+    size_t compact_after;
+#ifdef XORLIST_STATS
+    /**
+     * The statistics gathered about the list. This points at
+     * \ref stats_storage, so that copies of the list passed by value still
+     * update the original.
+     */
+    struct list_stats *stats;
+    /**
+     * The storage for \ref stats.
+     */
+    struct list_stats stats_storage;
+#endif
+    /**
+     * The storage for the head and tail. Use \ref head and \ref tail rather
+     * than these, as list_reverse(list_t *) swaps which is which.
+     */
+    node_t ends[2];
 } list_t;
 
+/**
+ * @brief A position within a list
+ *
+ * A cursor remembers the node it is on along with the node before it, which
+ * is everything needed to step in either direction or to link and unlink
+ * nodes without walking the list again. Besides the elements, a cursor may
+ * rest on the head (before the first element) or the tail (after the last
+ * element) of the list.
+ *
+ * Changing the list other than through the cursor invalidates it.
+ */
+typedef struct
+{
+    /**
+     * The list being traversed.
+     */
+    list_t *list;
+    /**
+     * The node before the current node, or `nullptr` when the cursor is on
+     * the head.
+     */
+    node_t *prev;
+    /**
+     * The node the cursor is on.
+     */
+    node_t *curr;
+    /**
+     * The index of the current node. This is -1 on the head and the size of
+     * the list on the tail.
+     */
+    ssize_t idx;
+} list_cursor_t;
+
 /**
  * @brief A function to tear-down elements in a list
  * 
@@ -65,25 +246,88 @@ typedef struct
  */
 typedef void (*element_destructor)(list_val_t);
 
+/**
+ * @brief A function to order elements in a list
+ *
+ * This should return a negative value if the first \ref list_val_t sorts
+ * before the second, a positive value if it sorts after the second, and zero
+ * if the two are equivalent (like the comparator passed to `qsort`).
+ */
+typedef int (*element_comparator)(list_val_t, list_val_t);
+
+/**
+ * @brief A function to test elements of a list
+ *
+ * This is passed a \ref list_val_t and the context given by the caller, and
+ * should return whether the element matches.
+ */
+typedef bool (*element_predicate)(list_val_t, void *);
+
 /* Exported list functions */
 list_t *list_create(void);
+list_t *list_create_with_pool(size_t);
+list_t *list_create_inline(size_t);
+list_t *list_create_inline_with_pool(size_t, size_t);
 void list_destroy(list_t *, element_destructor);
+void list_destroy_async(list_t *, element_destructor);
+void list_destroy_async_wait(void);
+void list_init(list_t *);
+void list_fini(list_t *, element_destructor);
+void list_fini_async(list_t *, element_destructor);
 int list_insert(list_t *, size_t, list_val_t);
 int list_append(list_t *, list_val_t);
 int list_enqueue(list_t *, list_val_t);
 int list_prepend(list_t *, list_val_t);
 int list_push(list_t *, list_val_t);
+int list_insert_many(list_t *, size_t, const list_val_t *, size_t);
+int list_extend(list_t *, const list_val_t *, size_t);
+list_t *list_from_array(const list_val_t *, size_t);
+size_t list_to_array(list_t, list_val_t *, size_t);
 bool list_is_empty(list_t);
 list_val_t list_delete(list_t *, size_t);
+int list_delete_into(list_t *, size_t, void *);
 ssize_t list_remove(list_t *, list_val_t);
 list_val_t list_pop(list_t *);
 list_val_t list_dequeue(list_t *);
 list_val_t list_get(list_t, size_t);
+int list_get_into(list_t, size_t, void *);
 list_val_t list_peek(list_t);
 list_val_t list_set(list_t *, size_t, list_val_t);
 size_t list_size(list_t);
 ssize_t list_find(list_t, list_val_t);
+ssize_t list_find_by(list_t, list_val_t, element_comparator);
 bool list_contains(list_t, list_val_t);
+bool list_move_to_front(list_t *, list_val_t);
 void list_reverse(list_t *);
+int list_concat(list_t *, list_t *);
+int list_splice(list_t *, size_t, list_t *, size_t, size_t);
+list_t *list_split(list_t *, size_t);
+void list_sort(list_t *, element_comparator);
+int list_insert_sorted(list_t *, list_val_t, element_comparator);
+int list_merge_sorted(list_t *, list_t *, element_comparator);
+int list_anchors_enable(list_t *, size_t);
+void list_anchors_disable(list_t *);
+int list_hash_enable(list_t *);
+void list_hash_disable(list_t *);
+bool list_discard(list_t *, list_val_t);
+size_t list_remove_if(list_t *, element_predicate, void *, element_destructor);
+size_t list_retain(list_t *, element_predicate, void *, element_destructor);
+int list_compact(list_t *);
+void list_compact_auto(list_t *, size_t);
+int list_stats(list_t *, struct list_stats *);
+void list_stats_reset(list_t *);
+
+/* Exported cursor functions */
+list_cursor_t list_cursor_begin(list_t *);
+list_cursor_t list_cursor_end(list_t *);
+list_cursor_t list_cursor_at(list_t *, size_t);
+bool list_cursor_valid(list_cursor_t);
+bool list_cursor_next(list_cursor_t *);
+bool list_cursor_prev(list_cursor_t *);
+list_val_t list_cursor_get(list_cursor_t);
+list_val_t list_cursor_set(list_cursor_t *, list_val_t);
+int list_cursor_insert_before(list_cursor_t *, list_val_t);
+int list_cursor_insert_after(list_cursor_t *, list_val_t);
+list_val_t list_cursor_delete(list_cursor_t *);
 
 #endif
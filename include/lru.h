@@ -0,0 +1,58 @@
+/**
+ * @file lru.h
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef __LRU_H
+#define __LRU_H
+/*
+ * Header file for the LRU cache built on xorlist.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+#include "list.h"
+
+/**
+ * @brief A least-recently-used cache of items
+ *
+ * The cache holds up to \ref capacity items, ordered from the most recently
+ * used to the least. Items are compared by identity, exactly as in a
+ * \ref list_t. Looking an item up and marking it as used takes constant time
+ * and never allocates: the node holding it is found through a hash index
+ * and relinked at the front of the list. Adding an item to a full cache
+ * evicts the least recently used one, whose node is then reused.
+ */
+typedef struct
+{
+    /**
+     * The items, from the most recently used to the least. This list has a
+     * node pool and a hash index.
+     */
+    list_t *list;
+    /**
+     * The largest number of items the cache holds.
+     */
+    size_t capacity;
+    /**
+     * The function evicted items are passed to (or `nullptr`).
+     */
+    element_destructor evict;
+} lru_t;
+
+/* Exported LRU cache functions */
+lru_t *lru_create(size_t, element_destructor);
+void lru_destroy(lru_t *, element_destructor);
+bool lru_get(lru_t *, list_val_t);
+int lru_put(lru_t *, list_val_t);
+bool lru_remove(lru_t *, list_val_t);
+bool lru_contains(lru_t, list_val_t);
+list_val_t lru_oldest(lru_t);
+size_t lru_size(lru_t);
+
+#endif
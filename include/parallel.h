@@ -0,0 +1,50 @@
+/**
+ * @file parallel.h
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef __PARALLEL_H
+#define __PARALLEL_H
+/*
+ * Header file for processing xorlists on several threads.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+#include "list.h"
+
+/**
+ * @brief A function called on each element of a list
+ *
+ * It is passed the element and the context given by the caller. It may be
+ * called from several threads at once, on different elements.
+ */
+typedef void (*element_visitor)(list_val_t, void *);
+
+/**
+ * @brief A function folding an element into a partial result
+ *
+ * It is passed the partial result to update, the element and the context
+ * given by the caller.
+ */
+typedef void (*element_reducer)(void *, list_val_t, void *);
+
+/**
+ * @brief A function folding one partial result into another
+ *
+ * It is passed the partial result to update, the partial result of the
+ * elements that come after it and the context given by the caller.
+ */
+typedef void (*result_combiner)(void *, const void *, void *);
+
+/* Exported parallel functions */
+int list_foreach_parallel(list_t *, size_t, element_visitor, void *);
+int list_reduce_parallel(list_t *, size_t, void *, size_t, element_reducer, result_combiner,
+                         void *);
+
+#endif
@@ -0,0 +1,74 @@
+/**
+ * @file persist.h
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef __PERSIST_H
+#define __PERSIST_H
+/*
+ * Header file for saving xorlists to files and mapping them back in.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+#include "list.h"
+
+/**
+ * @brief A read-only list mapped straight from a saved image
+ *
+ * The image written by list_save(list_t *, const char *) is laid out just
+ * like a list in memory, except that each link is the XOR of the file
+ * offsets of its neighbors instead of their addresses. That makes it
+ * position-independent, so it can be mapped anywhere and traversed in place
+ * without parsing it or allocating anything per element.
+ *
+ * The elements are stored in list order, so list_view_get(list_view_t,
+ * size_t) takes constant time.
+ */
+typedef struct
+{
+    /**
+     * Where the image is mapped.
+     */
+    const unsigned char *base;
+    /**
+     * The length of the mapping in bytes.
+     */
+    size_t length;
+    /**
+     * The size of each element in bytes.
+     */
+    size_t elem_size;
+    /**
+     * The distance between nodes in the image.
+     */
+    size_t node_size;
+    /**
+     * The number of elements in the list.
+     */
+    size_t size;
+    /**
+     * The offset of the head node in the image.
+     */
+    size_t head;
+    /**
+     * The offset of the tail node in the image.
+     */
+    size_t tail;
+} list_view_t;
+
+/* Exported persistence functions */
+int list_save(list_t *, const char *);
+list_t *list_load(const char *);
+int list_view_open(list_view_t *, const char *);
+void list_view_close(list_view_t *);
+size_t list_view_size(list_view_t);
+const void *list_view_get(list_view_t, size_t);
+ssize_t list_view_find(list_view_t, const void *);
+
+#endif
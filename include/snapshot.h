@@ -0,0 +1,115 @@
+/**
+ * @file snapshot.h
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef __SNAPSHOT_H
+#define __SNAPSHOT_H
+/*
+ * Header file for publishing read-only snapshots of xorlists to other
+ * threads.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+#include "list.h"
+
+/**
+ * The most readers that can be registered with a \ref list_publisher_t at
+ * once.
+ */
+#define LIST_PUBLISHER_MAX_READERS 64
+
+/**
+ * The size of a cache line, used to keep readers from sharing one.
+ */
+#define LIST_PUBLISHER_CACHE_LINE 64
+
+/**
+ * @brief Something waiting for readers to move on before it is reclaimed
+ *
+ * This is either a snapshot that has been replaced or an element that the
+ * writer removed from its list.
+ */
+typedef struct list_retired list_retired_t;
+
+/**
+ * @brief A reader registered with a \ref list_publisher_t
+ */
+typedef struct
+{
+    /**
+     * The epoch the reader entered its current snapshot in, or 0 when it
+     * doesn't hold one.
+     */
+    alignas(LIST_PUBLISHER_CACHE_LINE) atomic_uint_fast64_t epoch;
+    /**
+     * Whether a thread has registered as this reader.
+     */
+    atomic_bool used;
+} list_reader_t;
+
+/**
+ * @brief Shares read-only snapshots of a list between one writer and any
+ * number of readers
+ *
+ * The writer keeps changing its own list as usual and calls
+ * list_publish(list_publisher_t *, list_t *) whenever readers should see the
+ * changes. Readers take the latest snapshot with
+ * list_snapshot(list_publisher_t *, size_t) and hand it back with
+ * list_snapshot_release(list_publisher_t *, size_t). Neither side ever
+ * waits for the other: snapshots that have been replaced, and elements
+ * passed to list_retire(list_publisher_t *, list_val_t, element_destructor),
+ * are reclaimed by the writer once every reader has moved past the epoch
+ * they were retired in.
+ *
+ * A list_publisher_t must not be moved or copied once it has been created.
+ */
+typedef struct
+{
+    /**
+     * The latest snapshot.
+     */
+    _Atomic(list_t *) current;
+    /**
+     * The current epoch, which advances every time a snapshot is published.
+     */
+    atomic_uint_fast64_t epoch;
+    /**
+     * The slots readers register in.
+     */
+    list_reader_t readers[LIST_PUBLISHER_MAX_READERS];
+    /**
+     * Things retired in earlier epochs. Only the writer uses this.
+     */
+    list_retired_t *retired;
+    /**
+     * Elements retired since the last snapshot was published, which may
+     * still be in it. Only the writer uses this.
+     */
+    list_retired_t *limbo;
+    /**
+     * The number of things waiting to be reclaimed.
+     */
+    size_t pending;
+} list_publisher_t;
+
+/* Exported snapshot functions */
+list_publisher_t *list_publisher_create(void);
+void list_publisher_destroy(list_publisher_t *);
+int list_publish(list_publisher_t *, list_t *);
+int list_retire(list_publisher_t *, list_val_t, element_destructor);
+size_t list_reclaim(list_publisher_t *);
+ssize_t list_reader_register(list_publisher_t *);
+void list_reader_unregister(list_publisher_t *, size_t);
+list_t *list_snapshot(list_publisher_t *, size_t);
+void list_snapshot_release(list_publisher_t *, size_t);
+
+#endif
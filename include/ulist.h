@@ -0,0 +1,85 @@
+/**
+ * @file ulist.h
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef __ULIST_H
+#define __ULIST_H
+/*
+ * Header file for the unrolled variant of xorlist.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+#include "list.h"
+
+/**
+ * The number of values stored in each chunk of an unrolled list. With a
+ * link and a count alongside them, a chunk fills two 64-byte cache lines on
+ * 64-bit hosts.
+ */
+#define ULIST_CHUNK_VALUES 14
+
+/**
+ * @brief A chunk of values in an unrolled list
+ *
+ * This is an opaque type.
+ */
+typedef struct chunk chunk_t;
+
+/**
+ * @brief The unrolled XOR Linked List
+ *
+ * This behaves exactly like a \ref list_t, but each XOR-linked node (a
+ * chunk) holds up to \ref ULIST_CHUNK_VALUES values. Chunks are split when
+ * they overflow and merged with their neighbor when they run low, so scans
+ * touch far fewer nodes and each value costs close to `sizeof(list_val_t)`.
+ */
+typedef struct
+{
+    /**
+     * The head of the list. This chunk never holds values.
+     */
+    chunk_t *head;
+    /**
+     * The tail of the list. This chunk never holds values.
+     */
+    chunk_t *tail;
+    /**
+     * The number of elements stored in the list.
+     */
+    size_t size;
+    /**
+     * Whether the values within each chunk are read back to front. This is
+     * what allows ulist_reverse(ulist_t *) to avoid touching any chunk.
+     */
+    bool reversed;
+} ulist_t;
+
+/* Exported unrolled list functions */
+ulist_t *ulist_create(void);
+void ulist_destroy(ulist_t *, element_destructor);
+int ulist_insert(ulist_t *, size_t, list_val_t);
+int ulist_append(ulist_t *, list_val_t);
+int ulist_enqueue(ulist_t *, list_val_t);
+int ulist_prepend(ulist_t *, list_val_t);
+int ulist_push(ulist_t *, list_val_t);
+bool ulist_is_empty(ulist_t);
+list_val_t ulist_delete(ulist_t *, size_t);
+ssize_t ulist_remove(ulist_t *, list_val_t);
+list_val_t ulist_pop(ulist_t *);
+list_val_t ulist_dequeue(ulist_t *);
+list_val_t ulist_get(ulist_t, size_t);
+list_val_t ulist_peek(ulist_t);
+list_val_t ulist_set(ulist_t *, size_t, list_val_t);
+size_t ulist_size(ulist_t);
+ssize_t ulist_find(ulist_t, list_val_t);
+bool ulist_contains(ulist_t, list_val_t);
+void ulist_reverse(ulist_t *);
+
+#endif
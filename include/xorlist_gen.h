@@ -0,0 +1,313 @@
+/**
+ * @file xorlist_gen.h
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef __XORLIST_GEN_H
+#define __XORLIST_GEN_H
+/*
+ * Header-only, type-specialized XOR Linked Lists.
+ *
+ * This file is licensed under the terms of the MIT License
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+/**
+ * @brief Compares two values with `==`
+ *
+ * This is the equality used by \ref XORLIST_DEFINE, which suits scalar
+ * element types (integers, floating point values and pointers).
+ */
+#define XORLIST_SCALAR_EQ(a, b) ((a) == (b))
+
+/**
+ * @brief Define an XOR Linked List of a scalar type
+ *
+ * This is \ref XORLIST_DEFINE_EQ with \ref XORLIST_SCALAR_EQ as the
+ * equality.
+ *
+ * @param name The prefix for the generated types and functions
+ * @param T The element type
+ */
+#define XORLIST_DEFINE(name, T) XORLIST_DEFINE_EQ(name, T, XORLIST_SCALAR_EQ)
+
+/**
+ * @brief Loop over every element of a generated list, front to back
+ *
+ * `it` is declared as a `name##_iter_t`; name##_ref(name##_iter_t) gives a
+ * pointer to the current element. The list must not be changed during the
+ * loop.
+ *
+ * @param name The prefix the list was defined with
+ * @param list A pointer to the list
+ * @param it The name of the iterator variable
+ */
+#define XORLIST_FOREACH(name, list, it)                                        \
+    for (name##_iter_t it = name##_begin(list); name##_valid(it); name##_next(&it))
+
+/**
+ * @brief Define an XOR Linked List of a given type
+ *
+ * This expands to a set of types and `static inline` functions that mirror
+ * the \ref list_t API for elements of type `T`, stored by value inside the
+ * nodes. Since every function is visible to the compiler at the call site,
+ * the link arithmetic, the traversal loops and the equality test all inline
+ * into the caller and are specialized for `T`.
+ *
+ * The following are defined (with `name_` standing for the prefix):
+ *
+ * - `name_t`, the list, and `name_node_t`, its nodes. A `name_t` must not be
+ *   moved or copied once initialized, like a \ref list_t set up with
+ *   list_init(list_t *).
+ * - `name_iter_t`, a position in the list, used with \ref XORLIST_FOREACH or
+ *   `name_begin`, `name_valid`, `name_next` and `name_ref`.
+ * - `name_init` and `name_fini`, which takes an optional function that is
+ *   passed a pointer to each remaining element.
+ * - `name_insert`, `name_append`, `name_enqueue`, `name_prepend` and
+ *   `name_push`, which return a non-zero value on failure.
+ * - `name_delete`, `name_pop` and `name_dequeue`, which copy the removed
+ *   element to an optional out pointer and return a non-zero value if there
+ *   was nothing to remove.
+ * - `name_get`, which returns a pointer to an element (or `nullptr`), and
+ *   `name_set`.
+ * - `name_size`, `name_is_empty`, `name_find`, `name_contains`,
+ *   `name_remove` and `name_reverse`.
+ *
+ * @param name The prefix for the generated types and functions
+ * @param T The element type
+ * @param eq A function or function-like macro taking two `T` values and
+ *        returning whether they are equal
+ */
+#define XORLIST_DEFINE_EQ(name, T, eq)                                         \
+    typedef struct name##_node {                                               \
+        struct name##_node *link;                                              \
+        T value;                                                               \
+    } name##_node_t;                                                           \
+                                                                               \
+    typedef struct                                                             \
+    {                                                                          \
+        name##_node_t *head;                                                   \
+        name##_node_t *tail;                                                   \
+        size_t size;                                                           \
+        name##_node_t ends[2];                                                 \
+    } name##_t;                                                                \
+                                                                               \
+    typedef struct                                                             \
+    {                                                                          \
+        name##_node_t *prev;                                                   \
+        name##_node_t *curr;                                                   \
+        name##_node_t *tail;                                                   \
+    } name##_iter_t;                                                           \
+                                                                               \
+    static inline name##_node_t *name##_xor(name##_node_t *a, name##_node_t *b) \
+    {                                                                          \
+        return (name##_node_t *)((uintptr_t)a ^ (uintptr_t)b);                 \
+    }                                                                          \
+                                                                               \
+    static inline void name##_init(name##_t *list)                             \
+    {                                                                          \
+        list->head = &list->ends[0];                                           \
+        list->tail = &list->ends[1];                                           \
+        list->head->link = list->tail;                                         \
+        list->tail->link = list->head;                                         \
+        list->size = 0;                                                        \
+    }                                                                          \
+                                                                               \
+    static inline name##_iter_t name##_begin(name##_t *list)                   \
+    {                                                                          \
+        name##_iter_t it = {list->head, list->head->link, list->tail};         \
+        return it;                                                             \
+    }                                                                          \
+                                                                               \
+    static inline bool name##_valid(name##_iter_t it)                          \
+    {                                                                          \
+        return it.curr != it.tail;                                             \
+    }                                                                          \
+                                                                               \
+    static inline void name##_next(name##_iter_t *it)                          \
+    {                                                                          \
+        name##_node_t *next = name##_xor(it->curr->link, it->prev);            \
+        it->prev = it->curr;                                                   \
+        it->curr = next;                                                       \
+    }                                                                          \
+                                                                               \
+    static inline T *name##_ref(name##_iter_t it)                              \
+    {                                                                          \
+        return &it.curr->value;                                                \
+    }                                                                          \
+                                                                               \
+    /* Finds the node at an index (the tail for the size), from either end. */ \
+    static inline name##_iter_t name##_seek(name##_t *list, size_t idx)        \
+    {                                                                          \
+        if (idx <= list->size / 2) {                                           \
+            name##_iter_t it = name##_begin(list);                             \
+            for (size_t i = 0; i < idx; i++) {                                 \
+                name##_next(&it);                                              \
+            }                                                                  \
+            return it;                                                         \
+        }                                                                      \
+        name##_iter_t it = {list->tail->link, list->tail, list->tail};         \
+        for (size_t i = list->size; i > idx; i--) {                            \
+            name##_node_t *prev = name##_xor(it.prev->link, it.curr);          \
+            it.curr = it.prev;                                                 \
+            it.prev = prev;                                                    \
+        }                                                                      \
+        return it;                                                             \
+    }                                                                          \
+                                                                               \
+    static inline void name##_unlink(name##_t *list, name##_node_t *prev,      \
+                                     name##_node_t *curr)                      \
+    {                                                                          \
+        name##_node_t *next = name##_xor(curr->link, prev);                    \
+        next->link = name##_xor(name##_xor(next->link, curr), prev);           \
+        prev->link = name##_xor(name##_xor(prev->link, curr), next);           \
+        list->size -= 1;                                                       \
+        free(curr);                                                            \
+    }                                                                          \
+                                                                               \
+    static inline void name##_fini(name##_t *list, void (*destroy)(T *))       \
+    {                                                                          \
+        while (list->size > 0) {                                               \
+            name##_node_t *first = list->head->link;                           \
+            if (destroy) {                                                     \
+                destroy(&first->value);                                        \
+            }                                                                  \
+            name##_unlink(list, list->head, first);                            \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    static inline int name##_insert(name##_t *list, size_t idx, T value)       \
+    {                                                                          \
+        if (idx > list->size) {                                                \
+            return EXIT_FAILURE;                                               \
+        }                                                                      \
+        name##_node_t *node = malloc(sizeof(name##_node_t));                   \
+        if (!node) {                                                           \
+            return EXIT_FAILURE;                                               \
+        }                                                                      \
+        name##_iter_t it = name##_seek(list, idx);                             \
+        node->value = value;                                                   \
+        node->link = name##_xor(it.prev, it.curr);                             \
+        it.curr->link = name##_xor(name##_xor(it.curr->link, it.prev), node);  \
+        it.prev->link = name##_xor(name##_xor(it.prev->link, it.curr), node);  \
+        list->size += 1;                                                       \
+        return EXIT_SUCCESS;                                                   \
+    }                                                                          \
+                                                                               \
+    static inline int name##_append(name##_t *list, T value)                   \
+    {                                                                          \
+        return name##_insert(list, list->size, value);                         \
+    }                                                                          \
+                                                                               \
+    static inline int name##_enqueue(name##_t *list, T value)                  \
+    {                                                                          \
+        return name##_insert(list, list->size, value);                         \
+    }                                                                          \
+                                                                               \
+    static inline int name##_prepend(name##_t *list, T value)                  \
+    {                                                                          \
+        return name##_insert(list, 0, value);                                  \
+    }                                                                          \
+                                                                               \
+    static inline int name##_push(name##_t *list, T value)                     \
+    {                                                                          \
+        return name##_insert(list, 0, value);                                  \
+    }                                                                          \
+                                                                               \
+    static inline int name##_delete(name##_t *list, size_t idx, T *out)        \
+    {                                                                          \
+        if (idx >= list->size) {                                               \
+            return EXIT_FAILURE;                                               \
+        }                                                                      \
+        name##_iter_t it = name##_seek(list, idx);                             \
+        if (out) {                                                             \
+            *out = it.curr->value;                                             \
+        }                                                                      \
+        name##_unlink(list, it.prev, it.curr);                                 \
+        return EXIT_SUCCESS;                                                   \
+    }                                                                          \
+                                                                               \
+    static inline int name##_pop(name##_t *list, T *out)                       \
+    {                                                                          \
+        return name##_delete(list, 0, out);                                    \
+    }                                                                          \
+                                                                               \
+    static inline int name##_dequeue(name##_t *list, T *out)                   \
+    {                                                                          \
+        return name##_delete(list, 0, out);                                    \
+    }                                                                          \
+                                                                               \
+    static inline T *name##_get(name##_t *list, size_t idx)                    \
+    {                                                                          \
+        if (idx >= list->size) {                                               \
+            return nullptr;                                                    \
+        }                                                                      \
+        return &name##_seek(list, idx).curr->value;                            \
+    }                                                                          \
+                                                                               \
+    static inline int name##_set(name##_t *list, size_t idx, T value)          \
+    {                                                                          \
+        T *slot = name##_get(list, idx);                                       \
+        if (!slot) {                                                           \
+            return EXIT_FAILURE;                                               \
+        }                                                                      \
+        *slot = value;                                                         \
+        return EXIT_SUCCESS;                                                   \
+    }                                                                          \
+                                                                               \
+    static inline size_t name##_size(name##_t *list)                           \
+    {                                                                          \
+        return list->size;                                                     \
+    }                                                                          \
+                                                                               \
+    static inline bool name##_is_empty(name##_t *list)                         \
+    {                                                                          \
+        return list->size == 0;                                                \
+    }                                                                          \
+                                                                               \
+    static inline ssize_t name##_find(name##_t *list, T value)                 \
+    {                                                                          \
+        ssize_t idx = 0;                                                       \
+        XORLIST_FOREACH(name, list, it)                                        \
+        {                                                                      \
+            if (eq(it.curr->value, value)) {                                   \
+                return idx;                                                    \
+            }                                                                  \
+            idx++;                                                             \
+        }                                                                      \
+        return -1;                                                             \
+    }                                                                          \
+                                                                               \
+    static inline bool name##_contains(name##_t *list, T value)                \
+    {                                                                          \
+        return name##_find(list, value) >= 0;                                  \
+    }                                                                          \
+                                                                               \
+    static inline ssize_t name##_remove(name##_t *list, T value)               \
+    {                                                                          \
+        ssize_t idx = 0;                                                       \
+        XORLIST_FOREACH(name, list, it)                                        \
+        {                                                                      \
+            if (eq(it.curr->value, value)) {                                   \
+                name##_unlink(list, it.prev, it.curr);                         \
+                return idx;                                                    \
+            }                                                                  \
+            idx++;                                                             \
+        }                                                                      \
+        return -1;                                                             \
+    }                                                                          \
+                                                                               \
+    static inline void name##_reverse(name##_t *list)                          \
+    {                                                                          \
+        name##_node_t *head = list->head;                                      \
+        list->head = list->tail;                                               \
+        list->tail = head;                                                     \
+    }
+
+#endif
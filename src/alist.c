@@ -0,0 +1,521 @@
+/**
+ * @internal
+ * @file alist.c
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * An implementation of an arena-backed XOR Linked List. The nodes are linked
+ * exactly like the nodes of a regular xorlist, except that the link is the
+ * XOR of two 32-bit indices into the arena instead of two addresses.
+ *
+ * @endinternal
+ */
+#include "alist.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+/**
+ * The number of nodes an arena starts out with room for.
+ */
+#define MIN_CAPACITY 16
+
+/**
+ * The index that stands for "no node". The arena never hands it out.
+ */
+#define NO_NODE 0
+
+struct anode {
+  uint32_t link;
+  alist_val_t value;
+};
+
+/**
+ * A node and the node before it, both as arena indices. This identifies the
+ * position of a single value.
+ */
+typedef struct {
+  uint32_t prev;
+  uint32_t curr;
+} anode_pair_t;
+
+/*
+ * Prototypes for the utility functions.
+ */
+
+static uint32_t node_next(alist_t *, uint32_t, uint32_t);
+static uint32_t node_alloc(alist_t *);
+static void node_free(alist_t *, uint32_t);
+static bool arena_grow(alist_t *, size_t);
+static int insert_at(alist_t *, anode_pair_t, alist_val_t);
+static alist_val_t delete_at(alist_t *, anode_pair_t);
+static anode_pair_t traverse_to_idx(alist_t *, size_t);
+
+/******
+ * Exported Functions
+ ******/
+
+/**
+ * @brief Initialize an arena list
+ *
+ * Creates a heap-allocated alist_t. This list can be used immediately. The
+ * returned list should not be passed to free directly and should be passed
+ * to alist_destroy(alist_t *, alist_destructor).
+ */
+alist_t *alist_create(void) {
+  alist_t *list = malloc(sizeof(alist_t));
+  anode_t *nodes = malloc(MIN_CAPACITY * sizeof(anode_t));
+
+  if (!list || !nodes) {
+    free(list);
+    free(nodes);
+    return nullptr;
+  }
+
+  /* Index 0 is reserved, then come the head and tail. */
+  list->nodes = nodes;
+  list->capacity = MIN_CAPACITY;
+  list->used = 3;
+  list->free = NO_NODE;
+  list->head = 1;
+  list->tail = 2;
+  list->size = 0;
+
+  nodes[NO_NODE] = (anode_t){.link = NO_NODE, .value = 0};
+  nodes[list->head] = (anode_t){.link = NO_NODE ^ list->tail, .value = 0};
+  nodes[list->tail] = (anode_t){.link = list->head ^ NO_NODE, .value = 0};
+
+  return list;
+}
+
+/**
+ * @brief Deconstruct an arena list
+ *
+ * This passes each stored value to the destroy argument (if one is given),
+ * in list order, then frees the whole arena at once.
+ *
+ * @param list The list to tear down
+ * @param destroy A function to properly free list elements (or `nullptr`)
+ */
+void alist_destroy(alist_t *list, alist_destructor destroy) {
+  if (destroy) {
+    uint32_t prev = list->head;
+    uint32_t curr = node_next(list, list->head, NO_NODE);
+    while (curr != list->tail) {
+      destroy(list->nodes[curr].value);
+      uint32_t next = node_next(list, curr, prev);
+      prev = curr;
+      curr = next;
+    }
+  }
+
+  free(list->nodes);
+  list->nodes = nullptr;
+  free(list);
+}
+
+/**
+ * @brief Make room in the arena for a number of elements
+ *
+ * The arena grows by doubling as elements are added; reserving room up
+ * front avoids copying it as it grows and sizes it exactly.
+ *
+ * @param list The list to make room in
+ * @param count The number of elements the list should have room for
+ * @return int A non-zero value on failure
+ */
+int alist_reserve(alist_t *list, size_t count) {
+  /* Leave room for the reserved index and the head and tail. */
+  if (count > UINT32_MAX - 3) {
+    return EXIT_FAILURE;
+  }
+  if (list->capacity >= count + 3) {
+    return EXIT_SUCCESS;
+  }
+
+  anode_t *nodes = realloc(list->nodes, (count + 3) * sizeof(anode_t));
+  if (!nodes) {
+    return EXIT_FAILURE;
+  }
+
+  list->nodes = nodes;
+  list->capacity = (uint32_t)(count + 3);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Add an item to the list at an index.
+ *
+ * @param list The list ot add the item to
+ * @param idx  The index to insert at
+ * @param value The value to add
+ * @return int A non-zero value on failure
+ */
+int alist_insert(alist_t *list, size_t idx, alist_val_t value) {
+  if (idx > list->size) {
+    return EXIT_FAILURE;
+  }
+
+  return insert_at(list, traverse_to_idx(list, idx), value);
+}
+
+/**
+ * @brief Add an item to the tail of the list
+ *
+ * @param list The list to add to
+ * @param value The value to add to the list
+ * @return int A non-zero value on failure
+ */
+int alist_append(alist_t *list, alist_val_t value) {
+  anode_pair_t pos = {.prev = list->nodes[list->tail].link ^ NO_NODE, .curr = list->tail};
+  return insert_at(list, pos, value);
+}
+
+/**
+ * @brief Add an item to the end of the queue
+ *
+ * This is an alias for alist_append(alist_t *, alist_val_t)
+ *
+ * @param list The list to add to
+ * @param value The value to add to the queue
+ * @return int A non-zero value on failure
+ */
+int alist_enqueue(alist_t *list, alist_val_t value) {
+  return alist_append(list, value);
+}
+
+/**
+ * @brief Add an item to the head of the list
+ *
+ * @param list The list to add to
+ * @param value The value to add to the list
+ * @return int A non-zero value on failure
+ */
+int alist_prepend(alist_t *list, alist_val_t value) {
+  anode_pair_t pos = {.prev = list->head, .curr = node_next(list, list->head, NO_NODE)};
+  return insert_at(list, pos, value);
+}
+
+/**
+ * @brief Add an item to the top of the stack
+ *
+ * This is an alias for alist_prepend(alist_t *, alist_val_t)
+ *
+ * @param list The list to add to
+ * @param value The value to push to the stack
+ * @return int A non-zero value on failure
+ */
+int alist_push(alist_t *list, alist_val_t value) {
+  return alist_prepend(list, value);
+}
+
+/**
+ * @brief Determine if the list is empty
+ *
+ * @param list The list
+ * @return true When the list is empty
+ * @return false If the list contains elements
+ */
+bool alist_is_empty(alist_t list) {
+  return list.size == 0;
+}
+
+/**
+ * @brief Remove an item from the list by its index
+ *
+ * @param list The list to remove the item from
+ * @param idx The index of the item to remove
+ * @param out Where to store the removed value (or `nullptr`)
+ * @return int A non-zero value if the index is out of bounds
+ */
+int alist_delete(alist_t *list, size_t idx, alist_val_t *out) {
+  if (idx >= list->size) {
+    return EXIT_FAILURE;
+  }
+
+  alist_val_t value = delete_at(list, traverse_to_idx(list, idx));
+  if (out) {
+    *out = value;
+  }
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Remove an item from the list by value
+ *
+ * This deletes the first matching item in a single walk.
+ *
+ * @param list The list to remove the item from
+ * @param value The value to remove from the list
+ * @return ssize_t The index where the item was previously (or -1 if not found)
+ */
+ssize_t alist_remove(alist_t *list, alist_val_t value) {
+  anode_pair_t pos = {.prev = list->head, .curr = node_next(list, list->head, NO_NODE)};
+  for (size_t idx = 0; pos.curr != list->tail; idx++) {
+    if (list->nodes[pos.curr].value == value) {
+      delete_at(list, pos);
+      return idx;
+    }
+    uint32_t next = node_next(list, pos.curr, pos.prev);
+    pos.prev = pos.curr;
+    pos.curr = next;
+  }
+
+  /* The item does not exist in the list. */
+  return -1;
+}
+
+/**
+ * @brief Remove an item from the top of the stack
+ *
+ * @param list The list to remove from
+ * @param out Where to store the removed value (or `nullptr`)
+ * @return int A non-zero value if the list is empty
+ */
+int alist_pop(alist_t *list, alist_val_t *out) {
+  return alist_delete(list, 0, out);
+}
+
+/**
+ * @brief Remove an item from the front of the queue
+ *
+ * @param list The list to remove from
+ * @param out Where to store the removed value (or `nullptr`)
+ * @return int A non-zero value if the list is empty
+ */
+int alist_dequeue(alist_t *list, alist_val_t *out) {
+  return alist_delete(list, 0, out);
+}
+
+/**
+ * @brief Get an item from the list by its index
+ *
+ * @param list The list
+ * @param idx The index of the item
+ * @param out Where to store the value
+ * @return int A non-zero value if the index is out of bounds
+ */
+int alist_get(alist_t list, size_t idx, alist_val_t *out) {
+  if (idx >= list.size) {
+    return EXIT_FAILURE;
+  }
+
+  *out = list.nodes[traverse_to_idx(&list, idx).curr].value;
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Get the item at the top of the stack (or the front of the queue)
+ *
+ * @param list The list
+ * @param out Where to store the value
+ * @return int A non-zero value if the list is empty
+ */
+int alist_peek(alist_t list, alist_val_t *out) {
+  return alist_get(list, 0, out);
+}
+
+/**
+ * @brief Replace the item at an index
+ *
+ * @param list The list to modify
+ * @param idx The index of the item
+ * @param value The new value
+ * @return int A non-zero value if the index is out of bounds
+ */
+int alist_set(alist_t *list, size_t idx, alist_val_t value) {
+  if (idx >= list->size) {
+    return EXIT_FAILURE;
+  }
+
+  list->nodes[traverse_to_idx(list, idx).curr].value = value;
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Get the number of elements in the list
+ *
+ * @param list The list
+ * @return size_t The number of elements
+ */
+size_t alist_size(alist_t list) {
+  return list.size;
+}
+
+/**
+ * @brief Find the index of an item in the list
+ *
+ * @param list The list to search
+ * @param value The value to look for
+ * @return ssize_t The index of the first match (or -1 if not found)
+ */
+ssize_t alist_find(alist_t list, alist_val_t value) {
+  uint32_t prev = list.head;
+  uint32_t curr = node_next(&list, list.head, NO_NODE);
+  for (size_t idx = 0; curr != list.tail; idx++) {
+    if (list.nodes[curr].value == value) {
+      return idx;
+    }
+    uint32_t next = node_next(&list, curr, prev);
+    prev = curr;
+    curr = next;
+  }
+
+  return -1;
+}
+
+/**
+ * @brief Determine whether the list contains an item
+ *
+ * @param list The list to search
+ * @param value The value to look for
+ * @return true If the value is in the list
+ * @return false Otherwise
+ */
+bool alist_contains(alist_t list, alist_val_t value) {
+  return alist_find(list, value) >= 0;
+}
+
+/**
+ * @brief Reverse the list in constant time
+ *
+ * As with list_reverse(list_t *), only the head and tail are swapped.
+ *
+ * @param list The list to reverse
+ */
+void alist_reverse(alist_t *list) {
+  uint32_t head = list->head;
+  list->head = list->tail;
+  list->tail = head;
+}
+
+/*****
+ * Utility Functions
+ *****/
+
+/**
+ * Gets the index of the node after curr, coming from prev.
+ */
+static uint32_t node_next(alist_t *list, uint32_t curr, uint32_t prev) {
+  return list->nodes[curr].link ^ prev;
+}
+
+/**
+ * Hands out an unused node, preferring removed nodes over growing the arena.
+ * Returns NO_NODE if the arena can't grow. Growing the arena may move it, so
+ * any pointers into it must be looked up again afterwards.
+ */
+static uint32_t node_alloc(alist_t *list) {
+  if (list->free != NO_NODE) {
+    uint32_t node = list->free;
+    list->free = list->nodes[node].link;
+    return node;
+  }
+
+  if (list->used == list->capacity && !arena_grow(list, (size_t)list->used + 1)) {
+    return NO_NODE;
+  }
+  return list->used++;
+}
+
+/**
+ * Puts a node on the freelist, which is threaded through the link fields.
+ */
+static void node_free(alist_t *list, uint32_t node) {
+  list->nodes[node].link = list->free;
+  list->free = node;
+}
+
+/**
+ * Doubles the arena until it holds at least the given number of nodes.
+ */
+static bool arena_grow(alist_t *list, size_t needed) {
+  if (needed > UINT32_MAX) {
+    return false;
+  }
+
+  size_t capacity = list->capacity;
+  while (capacity < needed) {
+    capacity *= 2;
+  }
+  if (capacity > UINT32_MAX) {
+    capacity = UINT32_MAX;
+  }
+
+  anode_t *nodes = realloc(list->nodes, capacity * sizeof(anode_t));
+  if (!nodes) {
+    return false;
+  }
+
+  list->nodes = nodes;
+  list->capacity = (uint32_t)capacity;
+  return true;
+}
+
+/**
+ * Links a new node holding value in between pos.prev and pos.curr.
+ */
+static int insert_at(alist_t *list, anode_pair_t pos, alist_val_t value) {
+  uint32_t node = node_alloc(list);
+  if (node == NO_NODE) {
+    return EXIT_FAILURE;
+  }
+
+  anode_t *nodes = list->nodes;
+  nodes[node].link = pos.prev ^ pos.curr;
+  nodes[node].value = value;
+  nodes[pos.prev].link ^= pos.curr ^ node;
+  nodes[pos.curr].link ^= pos.prev ^ node;
+
+  list->size += 1;
+  return EXIT_SUCCESS;
+}
+
+/**
+ * Unlinks pos.curr from the list and returns its value.
+ */
+static alist_val_t delete_at(alist_t *list, anode_pair_t pos) {
+  anode_t *nodes = list->nodes;
+  uint32_t next = node_next(list, pos.curr, pos.prev);
+  alist_val_t value = nodes[pos.curr].value;
+
+  nodes[pos.prev].link ^= pos.curr ^ next;
+  nodes[next].link ^= pos.curr ^ pos.prev;
+  node_free(list, pos.curr);
+
+  list->size -= 1;
+  return value;
+}
+
+/**
+ * Traverses the list from whichever end is closer and returns the node at
+ * the specified index along with the node before it. An index equal to the
+ * size of the list yields the tail as the current node.
+ */
+static anode_pair_t traverse_to_idx(alist_t *list, size_t idx) {
+  anode_pair_t pos;
+
+  if (idx <= list->size / 2) {
+    pos.prev = list->head;
+    pos.curr = node_next(list, list->head, NO_NODE);
+    for (size_t i = 0; i < idx; i++) {
+      uint32_t next = node_next(list, pos.curr, pos.prev);
+      pos.prev = pos.curr;
+      pos.curr = next;
+    }
+    return pos;
+  }
+
+  pos.curr = list->tail;
+  pos.prev = node_next(list, list->tail, NO_NODE);
+  for (size_t i = list->size; i > idx; i--) {
+    uint32_t prev = node_next(list, pos.prev, pos.curr);
+    pos.curr = pos.prev;
+    pos.prev = prev;
+  }
+  return pos;
+}
@@ -0,0 +1,282 @@
+/**
+ * @internal
+ * @file bqueue.c
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * A bounded blocking queue built on an XOR Linked List.
+ *
+ * @endinternal
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "bqueue.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <time.h>
+
+/*
+ * Prototypes for the utility functions.
+ */
+
+static struct timespec deadline_after(long);
+static bool wait_until(pthread_cond_t *, pthread_mutex_t *, long, const struct timespec *);
+
+/******
+ * Exported Functions
+ ******/
+
+/**
+ * @brief Create a bounded blocking queue
+ *
+ * The returned queue should be passed to bqueue_destroy(bqueue_t *,
+ * element_destructor) once no thread is using it.
+ *
+ * @param capacity The largest number of items to hold (which must not be 0)
+ * @return bqueue_t* The new queue (or nullptr on failure)
+ */
+bqueue_t *bqueue_create(size_t capacity) {
+  if (capacity == 0) {
+    return nullptr;
+  }
+
+  bqueue_t *queue = malloc(sizeof(bqueue_t));
+  if (!queue) {
+    return nullptr;
+  }
+
+  queue->list = list_create_with_pool(capacity < 256 ? capacity : 0);
+  if (!queue->list) {
+    free(queue);
+    return nullptr;
+  }
+
+  /* Timeouts are measured on the monotonic clock. */
+  pthread_condattr_t attr;
+  if (pthread_condattr_init(&attr)) {
+    list_destroy(queue->list, nullptr);
+    free(queue);
+    return nullptr;
+  }
+  if (pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) ||
+      pthread_mutex_init(&queue->lock, nullptr)) {
+    pthread_condattr_destroy(&attr);
+    list_destroy(queue->list, nullptr);
+    free(queue);
+    return nullptr;
+  }
+  if (pthread_cond_init(&queue->not_empty, &attr)) {
+    pthread_mutex_destroy(&queue->lock);
+    pthread_condattr_destroy(&attr);
+    list_destroy(queue->list, nullptr);
+    free(queue);
+    return nullptr;
+  }
+  if (pthread_cond_init(&queue->not_full, &attr)) {
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_mutex_destroy(&queue->lock);
+    pthread_condattr_destroy(&attr);
+    list_destroy(queue->list, nullptr);
+    free(queue);
+    return nullptr;
+  }
+  pthread_condattr_destroy(&attr);
+
+  queue->capacity = capacity;
+  queue->closed = false;
+
+  return queue;
+}
+
+/**
+ * @brief Deconstruct a bounded blocking queue
+ *
+ * No other thread may be using the queue. The items left in the queue are
+ * passed to destroy (if it isn't `nullptr`).
+ *
+ * @param queue The queue to tear down
+ * @param destroy A function to properly free queue elements (or `nullptr`)
+ */
+void bqueue_destroy(bqueue_t *queue, element_destructor destroy) {
+  list_destroy(queue->list, destroy);
+  pthread_cond_destroy(&queue->not_full);
+  pthread_cond_destroy(&queue->not_empty);
+  pthread_mutex_destroy(&queue->lock);
+  free(queue);
+}
+
+/**
+ * @brief Add an item to the back of the queue, waiting for room if needed
+ *
+ * @param queue The queue to add to
+ * @param value The value to add
+ * @param timeout_ms The longest to wait for room, in milliseconds (or
+ *        \ref BQUEUE_FOREVER)
+ * @return int A non-zero value if the item wasn't added because the wait
+ *         timed out, the queue was closed, or allocation failed
+ */
+int bqueue_enqueue(bqueue_t *queue, list_val_t value, long timeout_ms) {
+  struct timespec deadline = deadline_after(timeout_ms);
+  int result = EXIT_FAILURE;
+
+  pthread_mutex_lock(&queue->lock);
+
+  while (!queue->closed && queue->list->size >= queue->capacity) {
+    if (!wait_until(&queue->not_full, &queue->lock, timeout_ms, &deadline)) {
+      break;
+    }
+  }
+
+  if (!queue->closed && queue->list->size < queue->capacity) {
+    result = list_enqueue(queue->list, value);
+  }
+
+  pthread_mutex_unlock(&queue->lock);
+
+  if (result == EXIT_SUCCESS) {
+    pthread_cond_signal(&queue->not_empty);
+  }
+  return result;
+}
+
+/**
+ * @brief Remove the item at the front of the queue, waiting for one if needed
+ *
+ * @param queue The queue to remove from
+ * @param timeout_ms The longest to wait for an item, in milliseconds (or
+ *        \ref BQUEUE_FOREVER)
+ * @return list_val_t The first item in the queue (or nullptr if the wait
+ *         timed out or the queue is closed and empty)
+ */
+list_val_t bqueue_dequeue(bqueue_t *queue, long timeout_ms) {
+  list_val_t value = nullptr;
+  bqueue_dequeue_n(queue, &value, 1, timeout_ms);
+  return value;
+}
+
+/**
+ * @brief Remove up to a number of items from the front of the queue at once
+ *
+ * This waits until the queue has at least one item, then drains as many as
+ * it can (up to `max`) into `values` under a single acquisition of the lock.
+ *
+ * @param queue The queue to remove from
+ * @param values Where to store the removed values, in queue order
+ * @param max The largest number of values to remove
+ * @param timeout_ms The longest to wait for an item, in milliseconds (or
+ *        \ref BQUEUE_FOREVER)
+ * @return size_t The number of values removed (which is 0 if the wait timed
+ *         out or the queue is closed and empty)
+ */
+size_t bqueue_dequeue_n(bqueue_t *queue, list_val_t *values, size_t max, long timeout_ms) {
+  if (max == 0) {
+    return 0;
+  }
+
+  struct timespec deadline = deadline_after(timeout_ms);
+  size_t count = 0;
+
+  pthread_mutex_lock(&queue->lock);
+
+  while (!queue->closed && queue->list->size == 0) {
+    if (!wait_until(&queue->not_empty, &queue->lock, timeout_ms, &deadline)) {
+      break;
+    }
+  }
+
+  while (count < max && queue->list->size > 0) {
+    values[count++] = list_dequeue(queue->list);
+  }
+
+  pthread_mutex_unlock(&queue->lock);
+
+  /* Wake as many producers as there is now room for. */
+  if (count == 1) {
+    pthread_cond_signal(&queue->not_full);
+  } else if (count > 1) {
+    pthread_cond_broadcast(&queue->not_full);
+  }
+  return count;
+}
+
+/**
+ * @brief Close the queue
+ *
+ * Every waiting thread is woken up. Afterwards, adding items fails at once
+ * and removing them only fails (without waiting) once the queue is empty, so
+ * consumers can drain what is left.
+ *
+ * @param queue The queue to close
+ */
+void bqueue_close(bqueue_t *queue) {
+  pthread_mutex_lock(&queue->lock);
+  queue->closed = true;
+  pthread_mutex_unlock(&queue->lock);
+
+  pthread_cond_broadcast(&queue->not_empty);
+  pthread_cond_broadcast(&queue->not_full);
+}
+
+/**
+ * @brief The size of the queue
+ *
+ * Other threads may change the size as soon as this returns.
+ *
+ * @param queue The queue to check the size of
+ * @return size_t The number of items in the queue
+ */
+size_t bqueue_size(bqueue_t *queue) {
+  pthread_mutex_lock(&queue->lock);
+  size_t size = queue->list->size;
+  pthread_mutex_unlock(&queue->lock);
+
+  return size;
+}
+
+/*****
+ * Utility Functions
+ *****/
+
+/**
+ * The time on the monotonic clock a number of milliseconds from now. Not
+ * meaningful for negative timeouts.
+ */
+static struct timespec deadline_after(long timeout_ms) {
+  struct timespec deadline;
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+  if (timeout_ms > 0) {
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec += 1;
+      deadline.tv_nsec -= 1000000000L;
+    }
+  }
+
+  return deadline;
+}
+
+/**
+ * Waits on a condition variable until it is signalled or the deadline
+ * passes, returning false once it has passed. A timeout of 0 never waits and
+ * a negative timeout never passes.
+ */
+static bool wait_until(pthread_cond_t *cond, pthread_mutex_t *lock, long timeout_ms,
+                       const struct timespec *deadline) {
+  if (timeout_ms == 0) {
+    return false;
+  }
+  if (timeout_ms < 0) {
+    pthread_cond_wait(cond, lock);
+    return true;
+  }
+
+  return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
@@ -0,0 +1,306 @@
+/**
+ * @internal
+ * @file cqueue.c
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * A concurrent queue built on the nodes of an XOR Linked List.
+ *
+ * This is a two-lock queue. Dequeuing k items rewrites the links of the head
+ * and the first k + 1 nodes (the last of which becomes the new first node),
+ * while enqueuing rewrites the links of the last node and the tail. Those
+ * sets of nodes can only overlap when the queue holds at most k + 1 items,
+ * so that's the only time consumers also take the tail lock. Since only
+ * consumers ever shrink the queue and only one of them holds the head lock
+ * at a time, a consumer that sees enough items knows they stay there.
+ *
+ * A lock-free version isn't possible with XOR links: unlinking a node
+ * changes the links of two other nodes, which can't be done with a single
+ * compare-and-swap.
+ *
+ * @endinternal
+ */
+#include "cqueue.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+#define UNSAFE_PTR_TO_INT(ptr) ((uintptr_t)(ptr))
+
+/*
+ * Prototypes for the utility functions.
+ */
+
+static node_t *calc_new_ptr(void *, void *, void *);
+static node_t *alloc_chain(const list_val_t *, size_t);
+static void free_chain(node_t *);
+static size_t lock_for_dequeue(cqueue_t *, size_t, bool *);
+
+/******
+ * Exported Functions
+ ******/
+
+/**
+ * @brief Initialize a concurrent queue
+ *
+ * Creates a heap-allocated cqueue_t. The returned queue should not be passed
+ * to free directly and should be passed to cqueue_destroy(cqueue_t *,
+ * element_destructor).
+ *
+ * @return cqueue_t* The new queue (or nullptr on failure)
+ */
+cqueue_t *cqueue_create(void) {
+  cqueue_t *queue = aligned_alloc(alignof(cqueue_t), sizeof(cqueue_t));
+  if (!queue) {
+    return nullptr;
+  }
+
+  if (pthread_mutex_init(&queue->head_lock, nullptr)) {
+    free(queue);
+    return nullptr;
+  }
+  if (pthread_mutex_init(&queue->tail_lock, nullptr)) {
+    pthread_mutex_destroy(&queue->head_lock);
+    free(queue);
+    return nullptr;
+  }
+
+  queue->head.link = calc_new_ptr(nullptr, nullptr, &queue->tail);
+  queue->head.value = nullptr;
+  queue->tail.link = calc_new_ptr(&queue->head, nullptr, nullptr);
+  queue->tail.value = nullptr;
+  atomic_init(&queue->size, 0);
+
+  return queue;
+}
+
+/**
+ * @brief Deconstruct a concurrent queue
+ *
+ * No other thread may be using the queue. The items left in the queue are
+ * passed to destroy (if it isn't `nullptr`).
+ *
+ * @param queue The queue to tear down
+ * @param destroy A function to properly free queue elements (or `nullptr`)
+ */
+void cqueue_destroy(cqueue_t *queue, element_destructor destroy) {
+  while (!cqueue_is_empty(queue)) {
+    list_val_t item = cqueue_dequeue(queue);
+    if (destroy) {
+      destroy(item);
+    }
+  }
+
+  pthread_mutex_destroy(&queue->head_lock);
+  pthread_mutex_destroy(&queue->tail_lock);
+  free(queue);
+}
+
+/**
+ * @brief Add an item to the back of the queue
+ *
+ * @param queue The queue to add to
+ * @param value The value to add
+ * @return int A non-zero value on failure
+ */
+int cqueue_enqueue(cqueue_t *queue, list_val_t value) {
+  return cqueue_enqueue_n(queue, &value, 1);
+}
+
+/**
+ * @brief Add several items to the back of the queue at once
+ *
+ * The nodes are allocated before taking the lock, which is then held just
+ * long enough to link all of them in. The items end up next to each other
+ * in the queue, in the order given.
+ *
+ * @param queue The queue to add to
+ * @param values The values to add
+ * @param count The number of values
+ * @return int A non-zero value on failure (in which case nothing is added)
+ */
+int cqueue_enqueue_n(cqueue_t *queue, const list_val_t *values, size_t count) {
+  if (count == 0) {
+    return EXIT_SUCCESS;
+  }
+
+  node_t *chain = alloc_chain(values, count);
+  if (!chain) {
+    return EXIT_FAILURE;
+  }
+
+  pthread_mutex_lock(&queue->tail_lock);
+
+  node_t *tail = &queue->tail;
+  node_t *last = calc_new_ptr(tail->link, nullptr, nullptr);
+  while (chain) {
+    node_t *node = chain;
+    chain = chain->link;
+
+    node->link = calc_new_ptr(last, nullptr, tail);
+    last->link = calc_new_ptr(last->link, tail, node);
+    last = node;
+  }
+  tail->link = calc_new_ptr(last, nullptr, nullptr);
+
+  /* Consumers rely on the nodes being linked before they are counted. */
+  atomic_fetch_add(&queue->size, count);
+
+  pthread_mutex_unlock(&queue->tail_lock);
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Remove the item at the front of the queue
+ *
+ * @param queue The queue to remove from
+ * @return list_val_t The first item in the queue (or nullptr if empty)
+ */
+list_val_t cqueue_dequeue(cqueue_t *queue) {
+  list_val_t value = nullptr;
+  cqueue_dequeue_n(queue, &value, 1);
+  return value;
+}
+
+/**
+ * @brief Remove up to a number of items from the front of the queue at once
+ *
+ * The items are written to `values` in the order they were queued. The lock
+ * is only taken once, and the nodes are freed after it has been released.
+ *
+ * @param queue The queue to remove from
+ * @param values Where to store the removed values
+ * @param max The largest number of values to remove
+ * @return size_t The number of values removed (which is 0 if the queue is
+ *         empty)
+ */
+size_t cqueue_dequeue_n(cqueue_t *queue, list_val_t *values, size_t max) {
+  if (max == 0) {
+    return 0;
+  }
+
+  bool exclusive;
+  size_t count = lock_for_dequeue(queue, max, &exclusive);
+  if (count > max) {
+    count = max;
+  }
+
+  node_t *head = &queue->head;
+  node_t *first = calc_new_ptr(nullptr, head->link, nullptr);
+  node_t *done = nullptr;
+  for (size_t i = 0; i < count; i++) {
+    node_t *next = calc_new_ptr(head, first->link, nullptr);
+    next->link = calc_new_ptr(next->link, first, head);
+    values[i] = first->value;
+
+    /* The removed nodes are chained together to be freed later. */
+    first->link = done;
+    done = first;
+    first = next;
+  }
+  head->link = calc_new_ptr(nullptr, nullptr, first);
+
+  atomic_fetch_sub(&queue->size, count);
+
+  if (exclusive) {
+    pthread_mutex_unlock(&queue->tail_lock);
+  }
+  pthread_mutex_unlock(&queue->head_lock);
+
+  free_chain(done);
+  return count;
+}
+
+/**
+ * @brief The size of the queue
+ *
+ * Other threads may change the size as soon as this returns.
+ *
+ * @param queue The queue to check the size of
+ * @return size_t The number of items in the queue
+ */
+size_t cqueue_size(cqueue_t *queue) {
+  return atomic_load(&queue->size);
+}
+
+/**
+ * @brief Check if the queue is empty
+ *
+ * Other threads may change the size as soon as this returns.
+ *
+ * @param queue The queue to check
+ * @return true If the queue has no items in it
+ * @return false If the queue has items in it
+ */
+bool cqueue_is_empty(cqueue_t *queue) {
+  return cqueue_size(queue) == 0;
+}
+
+/*****
+ * Utility Functions
+ *****/
+
+/**
+ * Calculates the new link for a node. Useful for insertions and removals.
+ */
+static node_t *calc_new_ptr(void *a, void *b, void *c) {
+  return (node_t *)(UNSAFE_PTR_TO_INT(a) ^ UNSAFE_PTR_TO_INT(b) ^ UNSAFE_PTR_TO_INT(c));
+}
+
+/**
+ * Allocates a node for each value, chained together through their links in
+ * order. Returns nullptr (having freed anything allocated) on failure.
+ */
+static node_t *alloc_chain(const list_val_t *values, size_t count) {
+  node_t *chain = nullptr;
+
+  /* Build the chain back to front so it comes out in order. */
+  for (size_t i = count; i > 0; i--) {
+    node_t *node = malloc(sizeof(node_t));
+    if (!node) {
+      free_chain(chain);
+      return nullptr;
+    }
+    node->value = values[i - 1];
+    node->link = chain;
+    chain = node;
+  }
+
+  return chain;
+}
+
+/**
+ * Frees a chain of nodes linked through their links.
+ */
+static void free_chain(node_t *chain) {
+  while (chain) {
+    node_t *next = chain->link;
+    free(chain);
+    chain = next;
+  }
+}
+
+/**
+ * Takes the locks needed to dequeue up to max items and returns the number
+ * of items in the queue. The tail lock is also taken (and exclusive set)
+ * when the producers might otherwise touch the same nodes.
+ */
+static size_t lock_for_dequeue(cqueue_t *queue, size_t max, bool *exclusive) {
+  pthread_mutex_lock(&queue->head_lock);
+
+  size_t count = atomic_load(&queue->size);
+  *exclusive = count < 2 || count - 2 < max;
+  if (*exclusive) {
+    pthread_mutex_lock(&queue->tail_lock);
+    count = atomic_load(&queue->size);
+  }
+
+  return count;
+}
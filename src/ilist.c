@@ -0,0 +1,382 @@
+/**
+ * @internal
+ * @file ilist.c
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * An implementation of an intrusive XOR Linked List. The links live inside
+ * the caller's elements, so nothing here ever allocates.
+ *
+ * @endinternal
+ */
+#include "ilist.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+#define UNSAFE_PTR_TO_INT(ptr) ((uintptr_t)(ptr))
+
+/**
+ * A link and the link before it.
+ */
+typedef struct {
+  xor_link_t *prev;
+  xor_link_t *curr;
+} link_pair_t;
+
+/*
+ * Prototypes for the utility functions.
+ */
+
+static xor_link_t *calc_new_ptr(void *, void *, void *);
+static xor_link_t *ilist_next(xor_link_t *, xor_link_t *);
+static void link_between(ilist_t *, xor_link_t *, xor_link_t *, xor_link_t *);
+static xor_link_t *unlink_at(ilist_t *, xor_link_t *, xor_link_t *);
+static link_pair_t traverse_to_idx(ilist_t *, size_t);
+
+/******
+ * Exported Functions
+ ******/
+
+/**
+ * @brief Initialize an intrusive list
+ *
+ * The list can be used immediately. Since the list doesn't own its elements,
+ * there is nothing to tear down; use ilist_clear(ilist_t *, ilist_release)
+ * to let go of the elements.
+ *
+ * @param list The storage to initialize
+ */
+void ilist_init(ilist_t *list) {
+  xor_link_t *head = &list->ends[0];
+  xor_link_t *tail = &list->ends[1];
+
+  head->link = calc_new_ptr(nullptr, nullptr, tail);
+  tail->link = calc_new_ptr(head, nullptr, nullptr);
+
+  list->head = head;
+  list->tail = tail;
+  list->size = 0;
+}
+
+/**
+ * @brief Remove every element from the list
+ *
+ * Each element is unlinked before it is passed to release, so release may
+ * free it.
+ *
+ * @param list The list to empty
+ * @param release A function to pass each element to (or `nullptr`)
+ */
+void ilist_clear(ilist_t *list, ilist_release release) {
+  while (list->size > 0) {
+    xor_link_t *item = ilist_pop(list);
+    if (release) {
+      release(item);
+    }
+  }
+}
+
+/**
+ * @brief Add an element to the list at an index
+ *
+ * The element must not already be in a list through the same link.
+ *
+ * @param list The list to add the element to
+ * @param idx The index to insert at
+ * @param item The link of the element to add
+ * @return int A non-zero value on failure
+ */
+int ilist_insert(ilist_t *list, size_t idx, xor_link_t *item) {
+  link_pair_t links = traverse_to_idx(list, idx);
+  if (!links.curr) {
+    return EXIT_FAILURE;
+  }
+
+  link_between(list, item, links.prev, links.curr);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Add an element to the end of the list
+ *
+ * @param list The list to add the element to
+ * @param item The link of the element to add
+ * @return int A non-zero value on failure
+ */
+int ilist_append(ilist_t *list, xor_link_t *item) {
+  return ilist_insert(list, list->size, item);
+}
+
+/**
+ * @brief Add an element to the end of the queue
+ *
+ * This is equivalent to ilist_append(ilist_t *, xor_link_t *).
+ *
+ * @param list The queue to add the element to
+ * @param item The link of the element to add
+ * @return int A non-zero value on failure
+ */
+int ilist_enqueue(ilist_t *list, xor_link_t *item) {
+  return ilist_append(list, item);
+}
+
+/**
+ * @brief Add an element to the start of the list
+ *
+ * @param list The list to add the element to
+ * @param item The link of the element to add
+ * @return int A non-zero value on failure
+ */
+int ilist_prepend(ilist_t *list, xor_link_t *item) {
+  return ilist_insert(list, 0, item);
+}
+
+/**
+ * @brief Push an element onto the top of the stack
+ *
+ * This is equivalent to ilist_prepend(ilist_t *, xor_link_t *).
+ *
+ * @param list The stack to add the element to
+ * @param item The link of the element to add
+ * @return int A non-zero value on failure
+ */
+int ilist_push(ilist_t *list, xor_link_t *item) {
+  return ilist_prepend(list, item);
+}
+
+/**
+ * @brief Check if the list is empty
+ *
+ * @param list The list to check
+ * @return true If the list has no elements
+ * @return false If the list has elements
+ */
+bool ilist_is_empty(ilist_t list) {
+  return list.size == 0;
+}
+
+/**
+ * @brief Remove the element at an index
+ *
+ * @param list The list to remove from
+ * @param idx The index to remove at
+ * @return xor_link_t* The link of the removed element (or nullptr for an
+ *         invalid index)
+ */
+xor_link_t *ilist_delete(ilist_t *list, size_t idx) {
+  if (idx >= list->size) {
+    return nullptr;
+  }
+
+  link_pair_t links = traverse_to_idx(list, idx);
+  return unlink_at(list, links.prev, links.curr);
+}
+
+/**
+ * @brief Remove an element from the list
+ *
+ * The element is found and unlinked in a single walk.
+ *
+ * @param list The list to remove from
+ * @param item The link of the element to remove
+ * @return ssize_t The index the element was at (or -1 if not found)
+ */
+ssize_t ilist_remove(ilist_t *list, xor_link_t *item) {
+  link_pair_t links = {.prev = list->head, .curr = ilist_next(list->head, nullptr)};
+
+  for (size_t idx = 0; links.curr != list->tail; idx++) {
+    if (links.curr == item) {
+      unlink_at(list, links.prev, links.curr);
+      return idx;
+    }
+    xor_link_t *next = ilist_next(links.curr, links.prev);
+    links.prev = links.curr;
+    links.curr = next;
+  }
+
+  return -1;
+}
+
+/**
+ * @brief Pop the top element from the stack
+ *
+ * @param list The stack to remove from
+ * @return xor_link_t* The link of the top element (or nullptr if empty)
+ */
+xor_link_t *ilist_pop(ilist_t *list) {
+  return ilist_delete(list, 0);
+}
+
+/**
+ * @brief Remove the first element from the queue
+ *
+ * @param list The queue to remove from
+ * @return xor_link_t* The link of the first element (or nullptr if empty)
+ */
+xor_link_t *ilist_dequeue(ilist_t *list) {
+  return ilist_delete(list, 0);
+}
+
+/**
+ * @brief Get (without removing) the element at an index
+ *
+ * @param list The list to look in
+ * @param idx The index to look at
+ * @return xor_link_t* The link of the element (or nullptr for an invalid
+ *         index)
+ */
+xor_link_t *ilist_get(ilist_t list, size_t idx) {
+  if (idx >= list.size) {
+    return nullptr;
+  }
+
+  return traverse_to_idx(&list, idx).curr;
+}
+
+/**
+ * @brief Peek at the first element in the queue (or top of the stack)
+ *
+ * @param list The stack/queue to peek at
+ * @return xor_link_t* The link of the first element (or nullptr if empty)
+ */
+xor_link_t *ilist_peek(ilist_t list) {
+  return ilist_get(list, 0);
+}
+
+/**
+ * @brief The size of the list
+ *
+ * @param list The list to check the size of
+ * @return size_t The current number of elements in the list
+ */
+size_t ilist_size(ilist_t list) {
+  return list.size;
+}
+
+/**
+ * @brief Get the index of an element in the list
+ *
+ * @param list The list to search
+ * @param item The link of the element to search for
+ * @return ssize_t The index of the element (or -1 if not found)
+ */
+ssize_t ilist_find(ilist_t list, xor_link_t *item) {
+  xor_link_t *prev = list.head;
+  xor_link_t *curr = ilist_next(list.head, nullptr);
+
+  for (size_t idx = 0; curr != list.tail; idx++) {
+    if (curr == item) {
+      return idx;
+    }
+    xor_link_t *next = ilist_next(curr, prev);
+    prev = curr;
+    curr = next;
+  }
+
+  return -1;
+}
+
+/**
+ * @brief Check if an element is in the list
+ *
+ * @param list The list to search
+ * @param item The link of the element to search for
+ * @return true If the element is in the list
+ * @return false If the element is not in the list
+ */
+bool ilist_contains(ilist_t list, xor_link_t *item) {
+  return ilist_find(list, item) >= 0;
+}
+
+/**
+ * @brief Reverse the list
+ *
+ * As with list_reverse(list_t *), only the head and tail are swapped.
+ *
+ * @param list The list to reverse
+ */
+void ilist_reverse(ilist_t *list) {
+  xor_link_t *head = list->head;
+  list->head = list->tail;
+  list->tail = head;
+}
+
+/*****
+ * Utility Functions
+ *****/
+
+/**
+ * Calculates the new link for a node. Useful for insertions and removals.
+ */
+static xor_link_t *calc_new_ptr(void *a, void *b, void *c) {
+  return (xor_link_t *)(UNSAFE_PTR_TO_INT(a) ^ UNSAFE_PTR_TO_INT(b) ^ UNSAFE_PTR_TO_INT(c));
+}
+
+/**
+ * Returns the link after curr.
+ */
+static xor_link_t *ilist_next(xor_link_t *curr, xor_link_t *prev) {
+  return calc_new_ptr(prev, curr->link, nullptr);
+}
+
+/**
+ * Links an element in between two given links.
+ */
+static void link_between(ilist_t *list, xor_link_t *item, xor_link_t *before, xor_link_t *after) {
+  item->link = calc_new_ptr(before, nullptr, after);
+  after->link = calc_new_ptr(before, item, after->link);
+  before->link = calc_new_ptr(before->link, item, after);
+  list->size += 1;
+}
+
+/**
+ * Unlinks the element after prev, returning it.
+ */
+static xor_link_t *unlink_at(ilist_t *list, xor_link_t *prev, xor_link_t *curr) {
+  xor_link_t *next = ilist_next(curr, prev);
+  next->link = calc_new_ptr(prev, curr, next->link);
+  prev->link = calc_new_ptr(prev->link, curr, next);
+  list->size -= 1;
+
+  /* Leave no stale pointers into the list behind. */
+  curr->link = nullptr;
+  return curr;
+}
+
+/**
+ * Traverses the list to the link at an index along with the link before it,
+ * starting from whichever end is closer. An index equal to the size of the
+ * list yields the tail.
+ */
+static link_pair_t traverse_to_idx(ilist_t *list, size_t idx) {
+  link_pair_t links = {.prev = nullptr, .curr = nullptr};
+  if (idx > list->size) {
+    return links;
+  }
+
+  if (idx <= list->size / 2) {
+    links.prev = list->head;
+    links.curr = ilist_next(list->head, nullptr);
+    for (size_t i = 0; i < idx; i++) {
+      xor_link_t *next = ilist_next(links.curr, links.prev);
+      links.prev = links.curr;
+      links.curr = next;
+    }
+    return links;
+  }
+
+  /* Walk backwards from the tail, where prev is the link before curr. */
+  links.curr = list->tail;
+  links.prev = calc_new_ptr(list->tail->link, nullptr, nullptr);
+  for (size_t i = list->size; i > idx; i--) {
+    xor_link_t *prev = calc_new_ptr(links.prev->link, links.curr, nullptr);
+    links.curr = links.prev;
+    links.prev = prev;
+  }
+  return links;
+}
@@ -0,0 +1,167 @@
+/**
+ * @internal
+ * @file lru.c
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * A least-recently-used cache built on an XOR Linked List with a hash index.
+ *
+ * @endinternal
+ */
+#include "lru.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+/******
+ * Exported Functions
+ ******/
+
+/**
+ * @brief Create an LRU cache
+ *
+ * The returned cache should be passed to lru_destroy(lru_t *,
+ * element_destructor) once it is no longer needed.
+ *
+ * @param capacity The largest number of items to hold (which must not be 0)
+ * @param evict A function to pass items evicted to make room for new ones
+ *        (or `nullptr`)
+ * @return lru_t* The new cache (or nullptr on failure)
+ */
+lru_t *lru_create(size_t capacity, element_destructor evict) {
+  if (capacity == 0) {
+    return nullptr;
+  }
+
+  lru_t *cache = malloc(sizeof(lru_t));
+  if (!cache) {
+    return nullptr;
+  }
+
+  /* Adding to a full cache briefly holds one item more than the capacity. */
+  cache->list = list_create_with_pool(capacity < 256 ? capacity + 1 : 0);
+  if (!cache->list) {
+    free(cache);
+    return nullptr;
+  }
+  if (list_hash_enable(cache->list)) {
+    list_destroy(cache->list, nullptr);
+    free(cache);
+    return nullptr;
+  }
+
+  cache->capacity = capacity;
+  cache->evict = evict;
+
+  return cache;
+}
+
+/**
+ * @brief Deconstruct an LRU cache
+ *
+ * The items still in the cache are passed to destroy, not to the eviction
+ * function given to lru_create(size_t, element_destructor).
+ *
+ * @param cache The cache to tear down
+ * @param destroy A function to properly free the items (or `nullptr`)
+ */
+void lru_destroy(lru_t *cache, element_destructor destroy) {
+  list_destroy(cache->list, destroy);
+  free(cache);
+}
+
+/**
+ * @brief Look an item up, marking it as the most recently used
+ *
+ * @param cache The cache to search
+ * @param value The item to look for
+ * @return true If the item is in the cache
+ * @return false If the item is not in the cache
+ */
+bool lru_get(lru_t *cache, list_val_t value) {
+  return list_move_to_front(cache->list, value);
+}
+
+/**
+ * @brief Add an item as the most recently used
+ *
+ * If the item is already in the cache, it is only marked as used. Otherwise,
+ * it is added and, if that takes the cache over its capacity, the least
+ * recently used item is removed and passed to the eviction function.
+ *
+ * @param cache The cache to add to
+ * @param value The item to add
+ * @return int A non-zero value on failure
+ */
+int lru_put(lru_t *cache, list_val_t value) {
+  if (list_move_to_front(cache->list, value)) {
+    return EXIT_SUCCESS;
+  }
+
+  if (list_prepend(cache->list, value)) {
+    return EXIT_FAILURE;
+  }
+
+  if (cache->list->size > cache->capacity) {
+    /* The last item is found by walking back from the tail in one step. */
+    list_val_t evicted = list_delete(cache->list, cache->list->size - 1);
+    if (cache->evict) {
+      cache->evict(evicted);
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Remove an item from the cache
+ *
+ * The item is not passed to the eviction function.
+ *
+ * @param cache The cache to remove from
+ * @param value The item to remove
+ * @return true If the item was removed
+ * @return false If the item is not in the cache
+ */
+bool lru_remove(lru_t *cache, list_val_t value) {
+  return list_discard(cache->list, value);
+}
+
+/**
+ * @brief Check if an item is in the cache without marking it as used
+ *
+ * @param cache The cache to search
+ * @param value The item to look for
+ * @return true If the item is in the cache
+ * @return false If the item is not in the cache
+ */
+bool lru_contains(lru_t cache, list_val_t value) {
+  return list_contains(*cache.list, value);
+}
+
+/**
+ * @brief Peek at the item that would be evicted next
+ *
+ * @param cache The cache to peek at
+ * @return list_val_t The least recently used item (or nullptr if empty)
+ */
+list_val_t lru_oldest(lru_t cache) {
+  if (cache.list->size == 0) {
+    return nullptr;
+  }
+
+  return list_get(*cache.list, cache.list->size - 1);
+}
+
+/**
+ * @brief The number of items in the cache
+ *
+ * @param cache The cache to check the size of
+ * @return size_t The current number of items in the cache
+ */
+size_t lru_size(lru_t cache) {
+  return cache.list->size;
+}
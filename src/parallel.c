@@ -0,0 +1,347 @@
+/**
+ * @internal
+ * @file parallel.c
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * Processing an XOR Linked List on several threads by splitting it into
+ * segments.
+ *
+ * @endinternal
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "parallel.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/**
+ * The fewest elements worth handing to another thread. Shorter segments
+ * spend more time waking a worker than walking the list.
+ */
+#define MIN_SEGMENT 1024
+
+/**
+ * A run of consecutive elements processed by one thread.
+ */
+typedef struct segment {
+  struct segment *next;
+  list_cursor_t start;
+  size_t count;
+  element_visitor visit;
+  element_reducer reduce;
+  void *ctx;
+  void *result;
+  /**
+   * The number of segments of the same call still being processed.
+   */
+  size_t *remaining;
+} segment_t;
+
+/**
+ * The worker threads that process segments, oldest first. Workers are
+ * started the first time a call wants more threads than there are and run
+ * for the life of the process.
+ */
+static struct {
+  pthread_mutex_t lock;
+  pthread_cond_t work;
+  pthread_cond_t done;
+  segment_t *first;
+  segment_t *last;
+  size_t workers;
+} pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+};
+
+/*
+ * Prototypes for the utility functions.
+ */
+
+static size_t segment_count(list_t *, size_t);
+static void split(list_t *, segment_t *, size_t);
+static void run(segment_t *, size_t);
+static void process(segment_t *);
+static segment_t *take(void);
+static void finish(segment_t *);
+static void *worker(void *);
+
+/******
+ * Exported Functions
+ ******/
+
+/**
+ * @brief Call a function on every element of a list using several threads
+ *
+ * The list is cut into one segment per thread, each of which is walked by
+ * its own thread: the calling thread takes the first and a pool of worker
+ * threads, started on first use and kept for the life of the process, takes
+ * the rest. Segments are at least a thousand or so elements long, so short
+ * lists use fewer threads (or just the calling one). The segments are found
+ * with the anchors when the list has them (see
+ * list_anchors_enable(list_t *, size_t)) and with one extra pass over the
+ * list otherwise. The list must not change until this returns.
+ *
+ * @param list The list to process
+ * @param threads The number of threads to use (or 0 for one per CPU)
+ * @param visit The function to call on each element
+ * @param ctx A value to pass to every call to visit
+ * @return int EXIT_SUCCESS or EXIT_FAILURE
+ */
+int list_foreach_parallel(list_t *list, size_t threads, element_visitor visit, void *ctx) {
+  size_t count = segment_count(list, threads);
+  if (count == 0) {
+    return EXIT_SUCCESS;
+  }
+
+  segment_t *segments = calloc(count, sizeof(segment_t));
+  if (!segments) {
+    return EXIT_FAILURE;
+  }
+
+  split(list, segments, count);
+  for (size_t i = 0; i < count; i++) {
+    segments[i].visit = visit;
+    segments[i].ctx = ctx;
+  }
+  run(segments, count);
+
+  free(segments);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Reduce the elements of a list to a single result using several
+ * threads
+ *
+ * The list is split between threads just as with
+ * list_foreach_parallel(list_t *, size_t, element_visitor, void *). Each
+ * thread folds its segment of the list into its own copy of the initial
+ * result with reduce, then the partial results are folded together
+ * with combine in list order, so the operation needs to be associative but
+ * not commutative. The initial result should be an identity for the
+ * operation (like 0 for a sum). The list must not change until this returns.
+ *
+ * @param list The list to reduce
+ * @param threads The number of threads to use (or 0 for one per CPU)
+ * @param result The initial result, which is replaced by the final one
+ * @param result_size The size of the result in bytes
+ * @param reduce The function to fold each element into a partial result
+ * @param combine The function to fold partial results together
+ * @param ctx A value to pass to every call to reduce and combine
+ * @return int EXIT_SUCCESS or EXIT_FAILURE
+ */
+int list_reduce_parallel(list_t *list, size_t threads, void *result, size_t result_size,
+                         element_reducer reduce, result_combiner combine, void *ctx) {
+  size_t count = segment_count(list, threads);
+  if (count == 0) {
+    return EXIT_SUCCESS;
+  }
+
+  segment_t *segments = calloc(count, sizeof(segment_t));
+  unsigned char *results = malloc(count * result_size);
+  if (!segments || !results) {
+    free(segments);
+    free(results);
+    return EXIT_FAILURE;
+  }
+
+  split(list, segments, count);
+  for (size_t i = 0; i < count; i++) {
+    segments[i].reduce = reduce;
+    segments[i].ctx = ctx;
+    segments[i].result = results + i * result_size;
+    memcpy(segments[i].result, result, result_size);
+  }
+  run(segments, count);
+
+  memcpy(result, results, result_size);
+  for (size_t i = 1; i < count; i++) {
+    combine(result, segments[i].result, ctx);
+  }
+
+  free(results);
+  free(segments);
+  return EXIT_SUCCESS;
+}
+
+/*****
+ * Utility Functions
+ *****/
+
+/**
+ * Decides how many segments to cut a list into for the requested number of
+ * threads (or 0 for one per CPU), keeping each at least MIN_SEGMENT long.
+ * Gives 0 if the list is empty.
+ */
+static size_t segment_count(list_t *list, size_t threads) {
+  if (list->size == 0) {
+    return 0;
+  }
+  if (threads == 0) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = cpus > 0 ? (size_t)cpus : 1;
+  }
+
+  size_t most = list->size / MIN_SEGMENT;
+  if (threads > most) {
+    threads = most;
+  }
+  return threads > 0 ? threads : 1;
+}
+
+/**
+ * Cuts a list into count segments of (nearly) equal length. With anchors,
+ * each segment starts from a cursor found through them. Otherwise the list
+ * is walked once, noting where each segment starts.
+ */
+static void split(list_t *list, segment_t *segments, size_t count) {
+  size_t length = list->size / count;
+  size_t extra = list->size % count;
+  for (size_t i = 0; i < count; i++) {
+    segments[i].count = length + (i < extra ? 1 : 0);
+  }
+
+  if (list->anchors) {
+    size_t idx = 0;
+    for (size_t i = 0; i < count; i++) {
+      segments[i].start = list_cursor_at(list, idx);
+      idx += segments[i].count;
+    }
+    return;
+  }
+
+  list_cursor_t cursor = list_cursor_begin(list);
+  for (size_t i = 0; i < count; i++) {
+    segments[i].start = cursor;
+    for (size_t j = 0; j < segments[i].count; j++) {
+      list_cursor_next(&cursor);
+    }
+  }
+}
+
+/**
+ * Processes every segment, the first on the calling thread and the rest on
+ * the workers, starting more workers if there aren't enough. While waiting
+ * for the workers, the calling thread helps with any queued segment, so
+ * every segment gets processed even if no worker could be started.
+ */
+static void run(segment_t *segments, size_t count) {
+  if (count == 1) {
+    process(&segments[0]);
+    return;
+  }
+
+  size_t remaining = count - 1;
+
+  pthread_mutex_lock(&pool.lock);
+  while (pool.workers < count - 1) {
+    pthread_t thread;
+    if (pthread_create(&thread, nullptr, worker, nullptr) != 0) {
+      break;
+    }
+    pthread_detach(thread);
+    pool.workers += 1;
+  }
+  for (size_t i = 1; i < count; i++) {
+    segments[i].remaining = &remaining;
+    segments[i].next = nullptr;
+    if (pool.last) {
+      pool.last->next = &segments[i];
+    } else {
+      pool.first = &segments[i];
+    }
+    pool.last = &segments[i];
+  }
+  pthread_cond_broadcast(&pool.work);
+  pthread_mutex_unlock(&pool.lock);
+
+  process(&segments[0]);
+
+  pthread_mutex_lock(&pool.lock);
+  while (remaining > 0) {
+    segment_t *segment = take();
+    if (!segment) {
+      pthread_cond_wait(&pool.done, &pool.lock);
+      continue;
+    }
+    pthread_mutex_unlock(&pool.lock);
+    process(segment);
+    pthread_mutex_lock(&pool.lock);
+    finish(segment);
+  }
+  pthread_mutex_unlock(&pool.lock);
+}
+
+/**
+ * Processes the elements of one segment.
+ */
+static void process(segment_t *segment) {
+  list_cursor_t cursor = segment->start;
+
+  for (size_t i = 0; i < segment->count; i++) {
+    list_val_t value = list_cursor_get(cursor);
+    if (segment->visit) {
+      segment->visit(value, segment->ctx);
+    } else {
+      segment->reduce(segment->result, value, segment->ctx);
+    }
+    list_cursor_next(&cursor);
+  }
+}
+
+/**
+ * Takes the oldest queued segment (or nullptr if there are none). The pool's
+ * lock must be held.
+ */
+static segment_t *take(void) {
+  segment_t *segment = pool.first;
+  if (segment) {
+    pool.first = segment->next;
+    if (!pool.first) {
+      pool.last = nullptr;
+    }
+  }
+  return segment;
+}
+
+/**
+ * Records that a segment has been processed. The pool's lock must be held,
+ * and the segment must not be touched afterwards since its call may return
+ * as soon as the lock is released.
+ */
+static void finish(segment_t *segment) {
+  *segment->remaining -= 1;
+  pthread_cond_broadcast(&pool.done);
+}
+
+/**
+ * Processes queued segments forever. Used as each worker's start routine.
+ */
+static void *worker(void *arg) {
+  (void)arg;
+
+  pthread_mutex_lock(&pool.lock);
+  for (;;) {
+    segment_t *segment = take();
+    if (!segment) {
+      pthread_cond_wait(&pool.work, &pool.lock);
+      continue;
+    }
+    pthread_mutex_unlock(&pool.lock);
+    process(segment);
+    pthread_mutex_lock(&pool.lock);
+    finish(segment);
+  }
+
+  return nullptr;
+}
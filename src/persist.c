@@ -0,0 +1,338 @@
+/**
+ * @internal
+ * @file persist.c
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * Saving XOR Linked Lists to position-independent images and mapping them
+ * back in.
+ *
+ * @endinternal
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include "persist.h"
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/**
+ * Identifies a list image.
+ */
+#define IMAGE_MAGIC "XORLIST"
+
+/**
+ * The version of the image layout.
+ */
+#define IMAGE_VERSION 1
+
+/**
+ * Written in native byte order to detect images from other machines.
+ */
+#define IMAGE_BYTE_ORDER 0x01020304u
+
+/**
+ * The header at the start of every list image. It is followed by `size + 2`
+ * nodes of `node_size` bytes each: the head sentinel, the elements in list
+ * order and the tail sentinel. Every node is an `uint64_t` link, the XOR of
+ * the offsets of its neighbors (with 0 past either end), followed by the
+ * element padded to 8 bytes.
+ */
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint64_t elem_size;
+  uint64_t node_size;
+  uint64_t size;
+  uint64_t head;
+  uint64_t tail;
+} image_header_t;
+
+/*
+ * Prototypes for the utility functions.
+ */
+
+static size_t image_next(list_view_t, size_t, size_t);
+static bool image_fits(size_t, size_t, size_t);
+
+/******
+ * Exported Functions
+ ******/
+
+/**
+ * @brief Write a list to a file
+ *
+ * Only lists that store their values inline (see list_create_inline(size_t))
+ * can be saved, since pointers would mean nothing once read back. The file
+ * can be read back with list_load(const char *) or mapped in place with
+ * list_view_open(list_view_t *, const char *).
+ *
+ * @param list The list to save
+ * @param path The file to write (which is replaced if it exists, and removed
+ *             again if writing fails partway)
+ * @return int EXIT_SUCCESS or EXIT_FAILURE
+ */
+int list_save(list_t *list, const char *path) {
+  if (list->elem_size == 0) {
+    return EXIT_FAILURE;
+  }
+
+  uint64_t node_size = sizeof(uint64_t) + ((list->elem_size + 7) & ~(size_t)7);
+  unsigned char *node = calloc(1, node_size);
+  if (!node) {
+    return EXIT_FAILURE;
+  }
+
+  FILE *file = fopen(path, "wb");
+  if (!file) {
+    free(node);
+    return EXIT_FAILURE;
+  }
+
+  image_header_t header = {
+      .magic = IMAGE_MAGIC,
+      .version = IMAGE_VERSION,
+      .byte_order = IMAGE_BYTE_ORDER,
+      .elem_size = list->elem_size,
+      .node_size = node_size,
+      .size = list->size,
+      .head = sizeof(image_header_t),
+      .tail = sizeof(image_header_t) + (list->size + 1) * node_size,
+  };
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+  /* The head sentinel's only neighbor is the first node (or the tail). */
+  uint64_t prev = 0;
+  uint64_t curr = header.head;
+  list_cursor_t cursor = list_cursor_begin(list);
+  for (size_t i = 0; ok && i < list->size + 2; i++) {
+    uint64_t next = curr == header.tail ? 0 : curr + node_size;
+    uint64_t link = prev ^ next;
+    memcpy(node, &link, sizeof(link));
+    if (i > 0 && list_cursor_valid(cursor)) {
+      memcpy(node + sizeof(link), list_cursor_get(cursor), list->elem_size);
+      list_cursor_next(&cursor);
+    } else {
+      memset(node + sizeof(link), 0, node_size - sizeof(link));
+    }
+    ok = fwrite(node, node_size, 1, file) == 1;
+    prev = curr;
+    curr = next;
+  }
+
+  free(node);
+  if (fclose(file) != 0) {
+    ok = false;
+  }
+
+  /* Don't leave a partial image behind that looks like a saved list. */
+  if (!ok) {
+    remove(path);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Read a list from a file
+ *
+ * The list is rebuilt as an inline list whose nodes all come from a single
+ * slab, so this allocates a handful of times regardless of the length. To
+ * read an image without copying it at all, see list_view_open(list_view_t *,
+ * const char *).
+ *
+ * @param path The file written by list_save(list_t *, const char *)
+ * @return list_t* The new list (or nullptr on failure)
+ */
+list_t *list_load(const char *path) {
+  list_view_t view;
+  if (list_view_open(&view, path)) {
+    return nullptr;
+  }
+
+  list_t *list = list_create_inline_with_pool(view.elem_size, view.size);
+  if (!list) {
+    list_view_close(&view);
+    return nullptr;
+  }
+
+  size_t prev = view.head;
+  size_t curr = image_next(view, 0, view.head);
+  while (curr != view.tail) {
+    if (curr == 0 || list->size == view.size ||
+        list_append(list, (list_val_t)(view.base + curr + sizeof(uint64_t)))) {
+      list_destroy(list, nullptr);
+      list_view_close(&view);
+      return nullptr;
+    }
+    size_t next = image_next(view, prev, curr);
+    prev = curr;
+    curr = next;
+  }
+
+  /* A damaged link can also reach the tail before every element is seen. */
+  bool complete = list->size == view.size;
+  list_view_close(&view);
+  if (!complete) {
+    list_destroy(list, nullptr);
+    return nullptr;
+  }
+  return list;
+}
+
+/**
+ * @brief Map a saved list into memory for reading in place
+ *
+ * The image is checked once when it is opened; nothing is copied or
+ * allocated per element. The view must be passed to
+ * list_view_close(list_view_t *) once it is no longer needed.
+ *
+ * @param view The view to set up
+ * @param path The file written by list_save(list_t *, const char *)
+ * @return int EXIT_SUCCESS or EXIT_FAILURE
+ */
+int list_view_open(list_view_t *view, const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return EXIT_FAILURE;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) || (size_t)info.st_size < sizeof(image_header_t)) {
+    close(fd);
+    return EXIT_FAILURE;
+  }
+
+  void *base = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    return EXIT_FAILURE;
+  }
+
+  const image_header_t *header = base;
+  if (memcmp(header->magic, IMAGE_MAGIC, sizeof(header->magic)) ||
+      header->version != IMAGE_VERSION || header->byte_order != IMAGE_BYTE_ORDER ||
+      header->elem_size == 0 || header->node_size < sizeof(uint64_t) ||
+      header->elem_size > header->node_size - sizeof(uint64_t) ||
+      header->node_size % sizeof(uint64_t) != 0 || header->head != sizeof(image_header_t) ||
+      !image_fits(header->size + 2, header->node_size, info.st_size - header->head) ||
+      header->tail != header->head + (header->size + 1) * header->node_size) {
+    munmap(base, info.st_size);
+    return EXIT_FAILURE;
+  }
+
+  view->base = base;
+  view->length = info.st_size;
+  view->elem_size = header->elem_size;
+  view->node_size = header->node_size;
+  view->size = header->size;
+  view->head = header->head;
+  view->tail = header->tail;
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Unmap a view of a saved list
+ *
+ * Pointers returned by list_view_get(list_view_t, size_t) are no longer
+ * valid afterwards.
+ *
+ * @param view The view to close
+ */
+void list_view_close(list_view_t *view) {
+  munmap((void *)view->base, view->length);
+  view->base = nullptr;
+  view->length = 0;
+  view->size = 0;
+}
+
+/**
+ * @brief Get the number of elements in a view
+ *
+ * @param view The view
+ * @return size_t The number of elements
+ */
+size_t list_view_size(list_view_t view) {
+  return view.size;
+}
+
+/**
+ * @brief Get an element of a view
+ *
+ * @param view The view
+ * @param idx The index of the element
+ * @return const void* A pointer to the element inside the mapping (or
+ *         nullptr if the index is out of bounds)
+ */
+const void *list_view_get(list_view_t view, size_t idx) {
+  if (idx >= view.size) {
+    return nullptr;
+  }
+
+  return view.base + view.head + (idx + 1) * view.node_size + sizeof(uint64_t);
+}
+
+/**
+ * @brief Find the first element of a view equal to a value
+ *
+ * This follows the links in the image just as list_find(list_t, list_val_t)
+ * does for an inline list, comparing the elements byte for byte.
+ *
+ * @param view The view to search
+ * @param value A pointer to the value to look for
+ * @return ssize_t The index of the element (or -1 if not found)
+ */
+ssize_t list_view_find(list_view_t view, const void *value) {
+  size_t prev = view.head;
+  size_t curr = image_next(view, 0, view.head);
+  for (size_t idx = 0; idx < view.size && curr != view.tail && curr != 0; idx++) {
+    if (!memcmp(view.base + curr + sizeof(uint64_t), value, view.elem_size)) {
+      return (ssize_t)idx;
+    }
+    size_t next = image_next(view, prev, curr);
+    prev = curr;
+    curr = next;
+  }
+
+  return -1;
+}
+
+/*****
+ * Utility Functions
+ *****/
+
+/**
+ * Gets the offset of the node after curr in an image, coming from prev (or 0
+ * before the head). Links that point outside the image or between nodes give
+ * 0, which ends any traversal early rather than reading out of bounds.
+ */
+static size_t image_next(list_view_t view, size_t prev, size_t curr) {
+  uint64_t link;
+  memcpy(&link, view.base + curr, sizeof(link));
+
+  uint64_t next = link ^ prev;
+  if (next < view.head || next > view.tail || (next - view.head) % view.node_size) {
+    return 0;
+  }
+  return next;
+}
+
+/**
+ * Checks that count nodes of node_size bytes fit in the available bytes left
+ * in an image, without overflowing.
+ */
+static bool image_fits(size_t count, size_t node_size, size_t available) {
+  return count >= 2 && node_size <= available / count;
+}
@@ -0,0 +1,357 @@
+/**
+ * @internal
+ * @file snapshot.c
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * Publishing read-only snapshots of an XOR Linked List with epoch-based
+ * reclamation.
+ *
+ * Readers can't walk the writer's own list while it changes: inserting or
+ * removing a node rewrites the links of both of its neighbors, and a reader
+ * between the two updates would XOR its way to a node that was never there.
+ * So each snapshot is a separate copy whose nodes come from one slab, made
+ * in a single pass and never changed afterwards.
+ *
+ * A reader announces the epoch it saw before loading the current snapshot.
+ * Replacing a snapshot advances the epoch, so anything retired in epoch `e`
+ * can only be held by readers that announced `e` or earlier, and is safe to
+ * reclaim once every announcement is later than that.
+ *
+ * @endinternal
+ */
+#include "snapshot.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+/**
+ * Something waiting to be reclaimed.
+ */
+struct list_retired {
+  struct list_retired *next;
+  /**
+   * The epoch it was retired in.
+   */
+  uint_fast64_t epoch;
+  /**
+   * The snapshot to destroy, or `nullptr` for an element.
+   */
+  list_t *snapshot;
+  list_val_t value;
+  element_destructor destroy;
+};
+
+/*
+ * Prototypes for the utility functions.
+ */
+
+static list_t *copy_list(list_t *);
+static list_retired_t *retired_create(list_t *, list_val_t, element_destructor);
+static void retired_reclaim(list_retired_t *);
+static uint_fast64_t oldest_reader(list_publisher_t *);
+
+/******
+ * Exported Functions
+ ******/
+
+/**
+ * @brief Create a publisher holding an empty snapshot
+ *
+ * @return list_publisher_t* The new publisher (or nullptr on failure)
+ */
+list_publisher_t *list_publisher_create(void) {
+  list_publisher_t *pub = aligned_alloc(alignof(list_publisher_t), sizeof(list_publisher_t));
+  if (!pub) {
+    return nullptr;
+  }
+
+  list_t *empty = list_create();
+  if (!empty) {
+    free(pub);
+    return nullptr;
+  }
+
+  atomic_init(&pub->current, empty);
+  atomic_init(&pub->epoch, 1);
+  pub->retired = nullptr;
+  pub->limbo = nullptr;
+  pub->pending = 0;
+  for (size_t i = 0; i < LIST_PUBLISHER_MAX_READERS; i++) {
+    atomic_init(&pub->readers[i].epoch, 0);
+    atomic_init(&pub->readers[i].used, false);
+  }
+
+  return pub;
+}
+
+/**
+ * @brief Destroy a publisher and everything it still holds
+ *
+ * Every pending element is passed to its destructor. No reader may be using
+ * a snapshot.
+ *
+ * @param pub The publisher to destroy
+ */
+void list_publisher_destroy(list_publisher_t *pub) {
+  list_retired_t *lists[] = {pub->retired, pub->limbo};
+  for (size_t i = 0; i < 2; i++) {
+    list_retired_t *retired = lists[i];
+    while (retired) {
+      list_retired_t *next = retired->next;
+      retired_reclaim(retired);
+      retired = next;
+    }
+  }
+
+  list_destroy(atomic_load(&pub->current), nullptr);
+  free(pub);
+}
+
+/**
+ * @brief Make the current contents of a list visible to readers
+ *
+ * The list is copied in one pass into a snapshot whose nodes are contiguous,
+ * which replaces the previous snapshot for readers that take one from now
+ * on. The previous snapshot (and the elements retired since it was
+ * published) are reclaimed once no reader can still be using them; this
+ * also reclaims whatever earlier epochs freed up. Only one thread may call
+ * this at a time.
+ *
+ * Snapshots of lists that store pointers share the elements with the list,
+ * so elements removed from the list should be handed to
+ * list_retire(list_publisher_t *, list_val_t, element_destructor) rather
+ * than freed.
+ *
+ * @param pub The publisher
+ * @param list The list to publish (which is not changed)
+ * @return int EXIT_SUCCESS or EXIT_FAILURE (in which case readers keep
+ *         seeing the previous snapshot)
+ */
+int list_publish(list_publisher_t *pub, list_t *list) {
+  list_t *copy = copy_list(list);
+  if (!copy) {
+    return EXIT_FAILURE;
+  }
+
+  list_retired_t *retired = retired_create(nullptr, nullptr, nullptr);
+  if (!retired) {
+    list_destroy(copy, nullptr);
+    return EXIT_FAILURE;
+  }
+
+  retired->snapshot = atomic_exchange(&pub->current, copy);
+  retired->epoch = atomic_fetch_add(&pub->epoch, 1);
+  retired->next = pub->retired;
+  pub->pending += 1;
+
+  /* Elements retired since the last publish may be in the old snapshot. */
+  while (pub->limbo) {
+    list_retired_t *next = pub->limbo->next;
+    pub->limbo->epoch = retired->epoch;
+    pub->limbo->next = retired;
+    retired = pub->limbo;
+    pub->limbo = next;
+  }
+  pub->retired = retired;
+
+  list_reclaim(pub);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Free an element once readers can no longer see it
+ *
+ * The element is passed to destroy once a snapshot without it has been
+ * published and every reader has released the snapshots that had it. Only
+ * the writer may call this.
+ *
+ * @param pub The publisher
+ * @param value The element, which should already be removed from the list
+ * @param destroy The function to free the element with
+ * @return int EXIT_SUCCESS or EXIT_FAILURE
+ */
+int list_retire(list_publisher_t *pub, list_val_t value, element_destructor destroy) {
+  list_retired_t *retired = retired_create(nullptr, value, destroy);
+  if (!retired) {
+    return EXIT_FAILURE;
+  }
+
+  retired->next = pub->limbo;
+  pub->limbo = retired;
+  pub->pending += 1;
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Reclaim everything that no reader can still be using
+ *
+ * This never waits for readers; whatever they might still hold is left for
+ * a later call. list_publish(list_publisher_t *, list_t *) calls this
+ * already. Only the writer may call this.
+ *
+ * @param pub The publisher
+ * @return size_t The number of snapshots and elements reclaimed
+ */
+size_t list_reclaim(list_publisher_t *pub) {
+  uint_fast64_t oldest = oldest_reader(pub);
+
+  size_t count = 0;
+  list_retired_t **link = &pub->retired;
+  while (*link) {
+    list_retired_t *retired = *link;
+    if (retired->epoch < oldest) {
+      *link = retired->next;
+      retired_reclaim(retired);
+      count++;
+    } else {
+      link = &retired->next;
+    }
+  }
+
+  pub->pending -= count;
+  return count;
+}
+
+/**
+ * @brief Register the calling thread as a reader
+ *
+ * Each reader needs its own id, which is passed to the other reader
+ * functions.
+ *
+ * @param pub The publisher
+ * @return ssize_t The reader's id (or -1 if there are already
+ *         \ref LIST_PUBLISHER_MAX_READERS readers)
+ */
+ssize_t list_reader_register(list_publisher_t *pub) {
+  for (size_t i = 0; i < LIST_PUBLISHER_MAX_READERS; i++) {
+    bool used = false;
+    if (atomic_compare_exchange_strong(&pub->readers[i].used, &used, true)) {
+      return (ssize_t)i;
+    }
+  }
+
+  return -1;
+}
+
+/**
+ * @brief Give up a reader id
+ *
+ * The reader must not be holding a snapshot.
+ *
+ * @param pub The publisher
+ * @param reader The reader's id
+ */
+void list_reader_unregister(list_publisher_t *pub, size_t reader) {
+  atomic_store(&pub->readers[reader].epoch, 0);
+  atomic_store(&pub->readers[reader].used, false);
+}
+
+/**
+ * @brief Take the latest snapshot
+ *
+ * The snapshot stays unchanged and valid until it is handed back with
+ * list_snapshot_release(list_publisher_t *, size_t), no matter what the
+ * writer does meanwhile, and it must be released before the reader takes
+ * another one. Only functions that read a list may be used on it, including
+ * cursors. Several readers may read the same snapshot at once, except in
+ * builds with `XORLIST_STATS` where its counters aren't synchronized.
+ *
+ * @param pub The publisher
+ * @param reader The reader's id
+ * @return list_t* The snapshot
+ */
+list_t *list_snapshot(list_publisher_t *pub, size_t reader) {
+  atomic_store(&pub->readers[reader].epoch, atomic_load(&pub->epoch));
+  return atomic_load(&pub->current);
+}
+
+/**
+ * @brief Hand back a snapshot taken with list_snapshot(list_publisher_t *,
+ * size_t)
+ *
+ * @param pub The publisher
+ * @param reader The reader's id
+ */
+void list_snapshot_release(list_publisher_t *pub, size_t reader) {
+  atomic_store(&pub->readers[reader].epoch, 0);
+}
+
+/*****
+ * Utility Functions
+ *****/
+
+/**
+ * Copies a list into a new one whose nodes come from a single slab. Gives
+ * nullptr on failure.
+ */
+static list_t *copy_list(list_t *list) {
+  size_t slab_nodes = list->size ? list->size : 1;
+  list_t *copy = list->elem_size ? list_create_inline_with_pool(list->elem_size, slab_nodes)
+                                 : list_create_with_pool(slab_nodes);
+  if (!copy) {
+    return nullptr;
+  }
+
+  for (list_cursor_t cursor = list_cursor_begin(list); list_cursor_valid(cursor);
+       list_cursor_next(&cursor)) {
+    if (list_append(copy, list_cursor_get(cursor))) {
+      list_destroy(copy, nullptr);
+      return nullptr;
+    }
+  }
+
+  return copy;
+}
+
+/**
+ * Allocates a record for a snapshot (or an element, when snapshot is
+ * `nullptr`) waiting to be reclaimed. Gives nullptr on failure.
+ */
+static list_retired_t *retired_create(list_t *snapshot, list_val_t value,
+                                      element_destructor destroy) {
+  list_retired_t *retired = malloc(sizeof(list_retired_t));
+  if (!retired) {
+    return nullptr;
+  }
+
+  retired->next = nullptr;
+  retired->epoch = 0;
+  retired->snapshot = snapshot;
+  retired->value = value;
+  retired->destroy = destroy;
+  return retired;
+}
+
+/**
+ * Frees a retired snapshot or element along with its record.
+ */
+static void retired_reclaim(list_retired_t *retired) {
+  if (retired->snapshot) {
+    list_destroy(retired->snapshot, nullptr);
+  } else if (retired->destroy) {
+    retired->destroy(retired->value);
+  }
+  free(retired);
+}
+
+/**
+ * Finds the earliest epoch announced by a reader holding a snapshot, or
+ * `UINT_FAST64_MAX` if no reader holds one.
+ */
+static uint_fast64_t oldest_reader(list_publisher_t *pub) {
+  uint_fast64_t oldest = UINT_FAST64_MAX;
+  for (size_t i = 0; i < LIST_PUBLISHER_MAX_READERS; i++) {
+    uint_fast64_t epoch = atomic_load(&pub->readers[i].epoch);
+    if (epoch != 0 && epoch < oldest) {
+      oldest = epoch;
+    }
+  }
+
+  return oldest;
+}
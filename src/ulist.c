@@ -0,0 +1,660 @@
+/**
+ * @internal
+ * @file ulist.c
+ * @author Laurel May (laurel@laurelmay.me)
+ *
+ * @copyright Copyright (c) 2022
+ *
+ * An implementation of an unrolled XOR Linked List. The chunks are linked
+ * exactly like the nodes of a regular xorlist; each one just holds several
+ * values instead of one.
+ *
+ * @endinternal
+ */
+#include "ulist.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#define UNSAFE_PTR_TO_INT(ptr) ((uintptr_t)(ptr))
+
+/**
+ * Chunks that drop below this many values are merged with a neighbor when
+ * the two fit in a single chunk.
+ */
+#define MERGE_THRESHOLD (ULIST_CHUNK_VALUES / 4)
+
+typedef struct chunk {
+  struct chunk *link;
+  size_t count;
+  list_val_t values[ULIST_CHUNK_VALUES];
+} chunk_t;
+
+/**
+ * A chunk, the chunk before it, and an offset within the chunk. This
+ * identifies the position of a single value.
+ */
+typedef struct {
+  chunk_t *prev;
+  chunk_t *curr;
+  size_t offset;
+} chunk_pos_t;
+
+/*
+ * Prototypes for the utility functions.
+ */
+
+static chunk_t *calc_new_ptr(void *, void *, void *);
+static chunk_t *chunk_next(chunk_t *, chunk_t *);
+static chunk_t *chunk_prev(chunk_t *, chunk_t *);
+static chunk_t *link_chunk(chunk_t *, chunk_t *);
+static void unlink_chunk(chunk_t *, chunk_t *, chunk_t *);
+static size_t slot(ulist_t *, chunk_t *, size_t);
+static void chunk_insert_value(ulist_t *, chunk_t *, size_t, list_val_t);
+static list_val_t chunk_remove_value(ulist_t *, chunk_t *, size_t);
+static void split_chunk(ulist_t *, chunk_t *, chunk_t *);
+static void merge_chunks(ulist_t *, chunk_t *, chunk_t *);
+static int insert_at(ulist_t *, chunk_pos_t, list_val_t);
+static list_val_t delete_at(ulist_t *, chunk_pos_t);
+static chunk_pos_t traverse_to_idx(ulist_t *, size_t);
+
+/******
+ * Exported Functions
+ ******/
+
+/**
+ * @brief Initialize an unrolled list
+ *
+ * Creates a heap-allocated ulist_t. This list can be used immediately. The
+ * returned list should not be passed to free directly and should be passed
+ * to ulist_destroy(ulist_t *, element_destructor).
+ */
+ulist_t *ulist_create(void) {
+  ulist_t *list = malloc(sizeof(ulist_t));
+  chunk_t *head = malloc(sizeof(chunk_t));
+  chunk_t *tail = malloc(sizeof(chunk_t));
+
+  if (!list || !head || !tail) {
+    free(list);
+    free(head);
+    free(tail);
+    return nullptr;
+  }
+
+  head->link = calc_new_ptr(nullptr, nullptr, tail);
+  head->count = 0;
+  tail->link = calc_new_ptr(head, nullptr, nullptr);
+  tail->count = 0;
+
+  list->head = head;
+  list->tail = tail;
+  list->size = 0;
+  list->reversed = false;
+
+  return list;
+}
+
+/**
+ * @brief Deconstruct an unrolled list
+ *
+ * This frees every chunk of the list after passing each stored value to the
+ * destroy argument (if one is given), in list order.
+ *
+ * @param list The list to tear down
+ * @param destroy A function to properly free list elements (or `nullptr`)
+ */
+void ulist_destroy(ulist_t *list, element_destructor destroy) {
+  chunk_t *prev = list->head;
+  chunk_t *curr = chunk_next(list->head, nullptr);
+
+  while (curr != list->tail) {
+    if (destroy) {
+      for (size_t i = 0; i < curr->count; i++) {
+        destroy(curr->values[slot(list, curr, i)]);
+      }
+    }
+
+    chunk_t *next = chunk_next(curr, prev);
+    /* The link of prev is no longer needed, so it can be freed now. */
+    if (prev != list->head) {
+      free(prev);
+    }
+    prev = curr;
+    curr = next;
+  }
+
+  if (prev != list->head) {
+    free(prev);
+  }
+  free(list->head);
+  free(list->tail);
+  list->head = nullptr;
+  list->tail = nullptr;
+  free(list);
+}
+
+/**
+ * @brief Add an item to the list at an index.
+ *
+ * @param list The list ot add the item to
+ * @param idx  The index to insert at
+ * @param value The value to add
+ * @return int A non-zero value on failure
+ */
+int ulist_insert(ulist_t *list, size_t idx, list_val_t value) {
+  if (idx > list->size) {
+    return EXIT_FAILURE;
+  }
+
+  return insert_at(list, traverse_to_idx(list, idx), value);
+}
+
+/**
+ * @brief Add an item to the tail of the list
+ *
+ * @param list The list to add to
+ * @param value The value to add to the list
+ * @return int A non-zero value on failure
+ */
+int ulist_append(ulist_t *list, list_val_t value) {
+  return ulist_insert(list, list->size, value);
+}
+
+/**
+ * @brief Add an item to the end of the queue
+ *
+ * This is an alias for ulist_append(ulist_t *, list_val_t)
+ *
+ * @param list The list to add to
+ * @param value The value to add to the list
+ * @return int A non-zero value on failure
+ */
+int ulist_enqueue(ulist_t *list, list_val_t value) {
+  return ulist_append(list, value);
+}
+
+/**
+ * @brief Add an item to the head of the list
+ *
+ * @param list The list to add to
+ * @param value The value to add to the list
+ * @return int A non-zero value on failure
+ */
+int ulist_prepend(ulist_t *list, list_val_t value) {
+  return ulist_insert(list, 0, value);
+}
+
+/**
+ * @brief Add an item to the top of the stack
+ *
+ * This is an alias for ulist_prepend(ulist_t *, list_val_t)
+ *
+ * @param list The list to add to
+ * @param value The value to push to the stack
+ * @return int A non-zero value on failure
+ */
+int ulist_push(ulist_t *list, list_val_t value) {
+  return ulist_prepend(list, value);
+}
+
+/**
+ * @brief Determine if the list is empty
+ *
+ * @param list The list
+ * @return true When the list is empty
+ * @return false If the list contains elements
+ */
+bool ulist_is_empty(ulist_t list) {
+  return list.size == 0;
+}
+
+/**
+ * @brief Remove an item from the list.
+ *
+ * This removes an item from the list at an index and returns the item.
+ *
+ * @param list The list to remove from
+ * @param idx The index to remove at
+ * @return list_val_t The item at that index (or nullptr for an invalid index)
+ */
+list_val_t ulist_delete(ulist_t *list, size_t idx) {
+  if (idx >= list->size) {
+    return nullptr;
+  }
+
+  return delete_at(list, traverse_to_idx(list, idx));
+}
+
+/**
+ * @brief Remove an item from the list by value
+ *
+ * This deletes the first matching item from the list by value and provides the
+ * index of the item in the list. It is the responsibility of the caller to
+ * ensure the memory for the value is deallocated corrected.
+ *
+ * @param list The list to remove the item from
+ * @param value The value to remove from the list
+ * @return ssize_t The index where the item was previously (or -1 if not found)
+ */
+ssize_t ulist_remove(ulist_t *list, list_val_t value) {
+  chunk_t *prev = list->head;
+  chunk_t *curr = chunk_next(list->head, nullptr);
+  size_t base = 0;
+
+  while (curr != list->tail) {
+    for (size_t i = 0; i < curr->count; i++) {
+      if (curr->values[slot(list, curr, i)] == value) {
+        chunk_pos_t pos = {.prev = prev, .curr = curr, .offset = i};
+        delete_at(list, pos);
+        return base + i;
+      }
+    }
+    base += curr->count;
+    chunk_t *next = chunk_next(curr, prev);
+    prev = curr;
+    curr = next;
+  }
+
+  return -1;
+}
+
+/**
+ * @brief Pop the top item from the stack
+ *
+ * This is equivalent to ulist_delete(ulist_t *, size_t) with an index of 0.
+ *
+ * @param list The list to remove from
+ * @return list_val_t The item at the top of the stack (or nullptr if empty)
+ */
+list_val_t ulist_pop(ulist_t *list) {
+  return ulist_delete(list, 0);
+}
+
+/**
+ * @brief Remove the first item from the queue
+ *
+ * This is equivalent to ulist_delete(ulist_t *, size_t) with an index of 0.
+ *
+ * @param list The queue to remove from
+ * @return list_val_t The first item in the queue (or nullptr if empty)
+ */
+list_val_t ulist_dequeue(ulist_t *list) {
+  return ulist_delete(list, 0);
+}
+
+/**
+ * @brief Get (without removing) the item at an index
+ *
+ * @param list The list to retrieve the item from
+ * @param idx  The index to retrieve at
+ * @return list_val_t The item to peek at
+ */
+list_val_t ulist_get(ulist_t list, size_t idx) {
+  if (idx >= list.size) {
+    return nullptr;
+  }
+
+  chunk_pos_t pos = traverse_to_idx(&list, idx);
+  return pos.curr->values[slot(&list, pos.curr, pos.offset)];
+}
+
+/**
+ * @brief Peek at the first item in the queue (or top of stack)
+ *
+ * @param list The stack/queue to peek at
+ * @return list_val_t The item at the front of queue (or top of the stack) or
+ *         nullptr if empty
+ */
+list_val_t ulist_peek(ulist_t list) {
+  return ulist_get(list, 0);
+}
+
+/**
+ * @brief Change the value stored at an index
+ *
+ * @param list The list to modify
+ * @param idx The index to modify
+ * @param value The new value to set
+ * @return list_val_t The previous at the given index (or nullptr if the index
+ *         is invalid)
+ */
+list_val_t ulist_set(ulist_t *list, size_t idx, list_val_t value) {
+  if (idx >= list->size) {
+    return nullptr;
+  }
+
+  chunk_pos_t pos = traverse_to_idx(list, idx);
+  size_t i = slot(list, pos.curr, pos.offset);
+  list_val_t prior_value = pos.curr->values[i];
+  pos.curr->values[i] = value;
+
+  return prior_value;
+}
+
+/**
+ * @brief The size of the list.
+ *
+ * @param list The list to check the size of
+ * @return size_t The current number of items in the list
+ */
+size_t ulist_size(ulist_t list) {
+  return list.size;
+}
+
+/**
+ * @brief Get the index of an item in the list
+ *
+ * This finds the first matching item (by value) in the list and provides the
+ * index of that item.
+ *
+ * @param list The list to search
+ * @param value The value to search for
+ * @return ssize_t The index of `value` or -1 if not found
+ */
+ssize_t ulist_find(ulist_t list, list_val_t value) {
+  chunk_t *prev = list.head;
+  chunk_t *curr = chunk_next(list.head, nullptr);
+  size_t base = 0;
+
+  while (curr != list.tail) {
+    for (size_t i = 0; i < curr->count; i++) {
+      if (curr->values[slot(&list, curr, i)] == value) {
+        return base + i;
+      }
+    }
+    base += curr->count;
+    chunk_t *next = chunk_next(curr, prev);
+    prev = curr;
+    curr = next;
+  }
+
+  /* The item does not exist in the list. */
+  return -1;
+}
+
+/**
+ * @brief Check if a value exists in the list
+ *
+ * Since the position of the value does not matter, each chunk is scanned in
+ * storage order.
+ *
+ * @param list The list to search in
+ * @param value The value to search for
+ * @return true If the value is found in the list
+ * @return false If the value is not found in the list
+ */
+bool ulist_contains(ulist_t list, list_val_t value) {
+  chunk_t *prev = list.head;
+  chunk_t *curr = chunk_next(list.head, nullptr);
+
+  while (curr != list.tail) {
+    for (size_t i = 0; i < curr->count; i++) {
+      if (curr->values[i] == value) {
+        return true;
+      }
+    }
+    chunk_t *next = chunk_next(curr, prev);
+    prev = curr;
+    curr = next;
+  }
+
+  /* The item does not exist in the list. */
+  return false;
+}
+
+/**
+ * @brief Reverse the list
+ *
+ * As with list_reverse(list_t *), the head and tail are swapped. The values
+ * inside each chunk are not moved; they are simply read in the opposite
+ * order from then on.
+ *
+ * @param list The list to reverse
+ */
+void ulist_reverse(ulist_t *list) {
+  chunk_t *head = list->head;
+  list->head = list->tail;
+  list->tail = head;
+  list->reversed = !list->reversed;
+}
+
+/*****
+ * Utility Functions
+ *****/
+
+/**
+ * Calculates the new link for a chunk. Useful for insertions and removals.
+ */
+static chunk_t *calc_new_ptr(void *a, void *b, void *c) {
+  return (chunk_t *)(UNSAFE_PTR_TO_INT(a) ^ UNSAFE_PTR_TO_INT(b) ^ UNSAFE_PTR_TO_INT(c));
+}
+
+/**
+ * Returns the next chunk in the list after curr.
+ */
+static chunk_t *chunk_next(chunk_t *curr, chunk_t *prev) {
+  return calc_new_ptr(prev, curr->link, nullptr);
+}
+
+/**
+ * Returns the previous chunk in the list before curr.
+ */
+static chunk_t *chunk_prev(chunk_t *curr, chunk_t *next) {
+  return calc_new_ptr(nullptr, curr->link, next);
+}
+
+/**
+ * Links a new, empty chunk between two given chunks.
+ */
+static chunk_t *link_chunk(chunk_t *before, chunk_t *after) {
+  chunk_t *new_chunk = malloc(sizeof(chunk_t));
+  if (!new_chunk) {
+    return nullptr;
+  }
+
+  new_chunk->count = 0;
+  new_chunk->link = calc_new_ptr(before, nullptr, after);
+  after->link = calc_new_ptr(before, new_chunk, after->link);
+  before->link = calc_new_ptr(before->link, new_chunk, after);
+
+  return new_chunk;
+}
+
+/**
+ * Unlinks and frees the chunk between two given chunks.
+ */
+static void unlink_chunk(chunk_t *before, chunk_t *curr, chunk_t *after) {
+  after->link = calc_new_ptr(before, curr, after->link);
+  before->link = calc_new_ptr(before->link, curr, after);
+  free(curr);
+}
+
+/**
+ * Maps an offset in list order to the slot of the chunk that holds it.
+ */
+static size_t slot(ulist_t *list, chunk_t *chunk, size_t offset) {
+  return list->reversed ? chunk->count - 1 - offset : offset;
+}
+
+/**
+ * Stores a value at an offset (in list order) in a chunk that has room.
+ */
+static void chunk_insert_value(ulist_t *list, chunk_t *chunk, size_t offset, list_val_t value) {
+  size_t i = list->reversed ? chunk->count - offset : offset;
+  memmove(chunk->values + i + 1, chunk->values + i, (chunk->count - i) * sizeof(list_val_t));
+  chunk->values[i] = value;
+  chunk->count += 1;
+}
+
+/**
+ * Removes the value at an offset (in list order) from a chunk.
+ */
+static list_val_t chunk_remove_value(ulist_t *list, chunk_t *chunk, size_t offset) {
+  size_t i = slot(list, chunk, offset);
+  list_val_t value = chunk->values[i];
+  memmove(chunk->values + i, chunk->values + i + 1, (chunk->count - i - 1) * sizeof(list_val_t));
+  chunk->count -= 1;
+  return value;
+}
+
+/**
+ * Moves the second half (in list order) of a full chunk into the empty chunk
+ * that follows it.
+ */
+static void split_chunk(ulist_t *list, chunk_t *chunk, chunk_t *fresh) {
+  size_t keep = chunk->count / 2;
+  size_t move = chunk->count - keep;
+
+  if (list->reversed) {
+    memcpy(fresh->values, chunk->values, move * sizeof(list_val_t));
+    memmove(chunk->values, chunk->values + move, keep * sizeof(list_val_t));
+  } else {
+    memcpy(fresh->values, chunk->values + keep, move * sizeof(list_val_t));
+  }
+
+  fresh->count = move;
+  chunk->count = keep;
+}
+
+/**
+ * Moves every value of a chunk onto the end (in list order) of the chunk
+ * before it. The caller ensures the values fit.
+ */
+static void merge_chunks(ulist_t *list, chunk_t *into, chunk_t *from) {
+  if (list->reversed) {
+    memmove(into->values + from->count, into->values, into->count * sizeof(list_val_t));
+    memcpy(into->values, from->values, from->count * sizeof(list_val_t));
+  } else {
+    memcpy(into->values + into->count, from->values, from->count * sizeof(list_val_t));
+  }
+
+  into->count += from->count;
+  from->count = 0;
+}
+
+/**
+ * Inserts a value at a position, making room by adding or splitting a chunk
+ * when needed.
+ */
+static int insert_at(ulist_t *list, chunk_pos_t pos, list_val_t value) {
+  chunk_t *prev = pos.prev;
+  chunk_t *curr = pos.curr;
+  size_t offset = pos.offset;
+
+  /*
+   * At the start of a chunk, the end of the chunk before it is the same
+   * position and may have room to spare.
+   */
+  if (offset == 0 && prev != list->head && prev->count < ULIST_CHUNK_VALUES) {
+    chunk_insert_value(list, prev, prev->count, value);
+    list->size += 1;
+    return EXIT_SUCCESS;
+  }
+
+  if (curr == list->tail || curr->count == ULIST_CHUNK_VALUES) {
+    if (curr == list->tail || offset == 0) {
+      /* Start a new chunk before curr. */
+      curr = link_chunk(prev, curr);
+      offset = 0;
+    } else if (offset == curr->count) {
+      /* Start a new chunk after curr. */
+      curr = link_chunk(curr, chunk_next(curr, prev));
+      offset = 0;
+    } else {
+      /* Split curr in two, then insert into whichever half holds offset. */
+      chunk_t *fresh = link_chunk(curr, chunk_next(curr, prev));
+      if (!fresh) {
+        return EXIT_FAILURE;
+      }
+      split_chunk(list, curr, fresh);
+      if (offset > curr->count) {
+        offset -= curr->count;
+        curr = fresh;
+      }
+    }
+
+    if (!curr) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  chunk_insert_value(list, curr, offset, value);
+  list->size += 1;
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * Removes the value at a position, merging or freeing its chunk if it
+ * becomes sparse or empty.
+ */
+static list_val_t delete_at(ulist_t *list, chunk_pos_t pos) {
+  chunk_t *prev = pos.prev;
+  chunk_t *curr = pos.curr;
+  chunk_t *next = chunk_next(curr, prev);
+
+  list_val_t value = chunk_remove_value(list, curr, pos.offset);
+  list->size -= 1;
+
+  if (curr->count == 0) {
+    unlink_chunk(prev, curr, next);
+  } else if (curr->count < MERGE_THRESHOLD) {
+    if (next != list->tail && curr->count + next->count <= ULIST_CHUNK_VALUES) {
+      merge_chunks(list, curr, next);
+      unlink_chunk(curr, next, chunk_next(next, curr));
+    } else if (prev != list->head && prev->count + curr->count <= ULIST_CHUNK_VALUES) {
+      merge_chunks(list, prev, curr);
+      unlink_chunk(prev, curr, next);
+    }
+  }
+
+  return value;
+}
+
+/**
+ * Traverses the list and returns the chunk holding the value at the
+ * specified index, the chunk before it and the offset of the value. An index
+ * equal to the size of the list yields the position just past the last
+ * value.
+ */
+static chunk_pos_t traverse_to_idx(ulist_t *list, size_t idx) {
+  chunk_pos_t pos;
+
+  if (idx <= list->size / 2) {
+    /* Walk forward from the head, skipping whole chunks. */
+    chunk_t *prev = list->head;
+    chunk_t *curr = chunk_next(list->head, nullptr);
+    while (curr != list->tail && idx >= curr->count) {
+      idx -= curr->count;
+      chunk_t *tmp = chunk_next(curr, prev);
+      prev = curr;
+      curr = tmp;
+    }
+    pos.prev = prev;
+    pos.curr = curr;
+    pos.offset = idx;
+  } else {
+    /*
+     * Search from the end of the list for indexes after halfway, counting
+     * how many values lie at or after idx.
+     */
+    size_t remaining = list->size - idx;
+    chunk_t *next = list->tail;
+    chunk_t *curr = chunk_prev(list->tail, nullptr);
+    while (remaining > curr->count) {
+      remaining -= curr->count;
+      chunk_t *tmp = chunk_prev(curr, next);
+      next = curr;
+      curr = tmp;
+    }
+    pos.prev = chunk_prev(curr, next);
+    pos.curr = curr;
+    pos.offset = curr->count - remaining;
+  }
+
+  return pos;
+}
@@ -12,19 +12,16 @@
  */
 #include "list.h"
 
+#include <pthread.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 
 #define UNSAFE_PTR_TO_INT(ptr) ((uintptr_t)(ptr))
 
-typedef struct node {
-  struct node *link;
-  list_val_t *value;
-} node_t;
-
 /**
  * Struct that can be used to find a surrounding node (or just be used for
  * the included nodes).
@@ -34,6 +31,171 @@ typedef struct {
   node_t *curr;
 } node_pair_t;
 
+/**
+ * The number of nodes in each slab when a pool is created without an
+ * explicit slab size.
+ */
+#define DEFAULT_SLAB_NODES 256
+
+/**
+ * Passed in place of an index when the position of a change in the list is
+ * not known.
+ */
+#define UNKNOWN_IDX SIZE_MAX
+
+/**
+ * Hints that a node or value will be read soon.
+ */
+#if XORLIST_PREFETCH_DISTANCE > 0 && (defined(__GNUC__) || defined(__clang__))
+#define PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define PREFETCH(addr) ((void)(addr))
+#endif
+
+/**
+ * The number of nodes a scan keeps found ahead of the one being looked at.
+ */
+#define SCAN_WINDOW (XORLIST_PREFETCH_DISTANCE > 0 ? XORLIST_PREFETCH_DISTANCE : 1)
+
+/**
+ * A forward walk over every node of a list that runs up to SCAN_WINDOW nodes
+ * ahead of the node handed out. Each node found ahead has its value
+ * prefetched (when asked to), so the value is already on its way by the time
+ * the node is handed out and whatever the caller does with it overlaps the
+ * walk to the next node. The list must not change during the scan.
+ */
+typedef struct {
+  list_t *list;
+  node_pair_t ahead;
+  node_t *window[SCAN_WINDOW];
+  size_t first;
+  size_t count;
+  bool values;
+} scan_t;
+
+/**
+ * Statistics are only gathered when built with XORLIST_STATS; otherwise
+ * these compile away to nothing.
+ */
+#ifdef XORLIST_STATS
+#define STATS_ADD(list, field, n) ((list)->stats->field += (n))
+#define STATS_WALK(list, steps) stats_walk((list), (steps))
+#else
+#define STATS_ADD(list, field, n) ((void)0)
+#define STATS_WALK(list, steps) ((void)0)
+#endif
+
+/**
+ * A contiguous block of count nodes owned by a pool. The nodes are node_size
+ * bytes apart, which is more than sizeof(node_t) for lists that store their
+ * values inline. Most slabs hold the pool's slab_nodes nodes, but bulk
+ * insertions may add a larger one.
+ */
+typedef struct slab {
+  struct slab *next;
+  size_t count;
+  node_t nodes[];
+} slab_t;
+
+/**
+ * A slab allocator for nodes of a single size. Slabs are only released when
+ * the pool is destroyed; until then, freed nodes are kept on a freelist that
+ * is threaded through their link fields.
+ *
+ * Lists split off from a pooled list share its pool so that nodes can move
+ * between them freely. The pool is destroyed once the last of those lists
+ * lets go of it.
+ *
+ * Splicing between lists with different pools merges the pools: one takes
+ * over the other's slabs and free nodes, and the other is left as an empty
+ * stub whose merged field points at it. Lists still holding the stub switch
+ * over the next time they need their pool (see pool_of), and the stub holds
+ * a reference to the pool it was merged into until then.
+ */
+struct list_pool {
+  slab_t *slabs;
+  slab_t *last_slab;
+  node_t *free;
+  size_t available;
+  size_t slab_nodes;
+  size_t node_size;
+  size_t refs;
+  struct list_pool *merged;
+};
+
+/**
+ * A sparse index into the list. The pair of nodes at every spacing-th index
+ * (other than 0) is kept so traversals can start from the nearest one. The
+ * anchors are shifted as nodes are added and removed; when a change happens
+ * at an unknown index they are marked stale and rebuilt on the next lookup.
+ */
+struct list_anchors {
+  node_pair_t *pairs;
+  size_t count;
+  size_t capacity;
+  size_t spacing;
+  bool stale;
+};
+
+/**
+ * The smallest number of slots in a hash index.
+ */
+#define HASH_MIN_CAPACITY 16
+
+/**
+ * An entry in the hash index. Besides the node holding the value, one of the
+ * node's neighbors (on either side) is kept, since that is all that's needed
+ * to unlink it.
+ */
+typedef struct {
+  list_val_t value;
+  node_t *node;
+  node_t *neighbor;
+} hash_entry_t;
+
+/**
+ * A hash index from values to the nodes holding them. The table uses linear
+ * probing and is kept at most half full; empty slots have no node. Every
+ * node in the list has exactly one entry, so equal values have an entry
+ * each.
+ */
+struct list_hash {
+  hash_entry_t *entries;
+  size_t count;
+  size_t capacity;
+};
+
+/**
+ * A list handed to the reclaimer by list_destroy_async. The nodes have been
+ * moved into a list of its own, so the original list_t is already gone.
+ */
+typedef struct teardown {
+  struct teardown *next;
+  element_destructor destroy;
+  list_t list;
+} teardown_t;
+
+/**
+ * The background thread that tears down lists passed to list_destroy_async,
+ * oldest first. It is started the first time it's needed and runs for the
+ * life of the process.
+ */
+static struct {
+  pthread_once_t once;
+  pthread_mutex_t lock;
+  pthread_cond_t work;
+  pthread_cond_t done;
+  teardown_t *first;
+  teardown_t *last;
+  size_t pending;
+  bool running;
+} reclaimer = {
+    .once = PTHREAD_ONCE_INIT,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+};
+
 /*
  * Prototypes for the utility functions.
  */
@@ -41,8 +203,60 @@ typedef struct {
 static node_t *calc_new_ptr(void *, void *, void *);
 static node_t *list_next(node_t *, node_t *);
 static node_t *list_prev(node_t *, node_t *);
-static int add_at_node(list_t *, list_val_t, node_t *, node_t *);
+static int add_at_node(list_t *, list_val_t, node_t *, node_t *, size_t);
+static node_t *link_node(list_t *, list_val_t, node_t *, node_t *, size_t);
+static void attach_node(list_t *, node_t *, node_t *, node_t *, size_t);
+static list_val_t remove_at_node(list_t *, node_t *, node_t *, size_t);
+static void detach_node(list_t *, node_t *, node_t *, size_t);
+static bool is_sentinel(list_t *, node_t *);
 static node_pair_t traverse_to_idx(list_t *, size_t);
+static node_pair_t walk_forward(node_pair_t, size_t);
+static size_t index_distance(size_t, size_t);
+static node_pair_t walk_backward(node_pair_t, size_t);
+static void scan_begin(scan_t *, list_t *, bool);
+static node_t *scan_next(scan_t *);
+static bool anchors_rebuild(list_t *);
+static bool anchors_reserve(list_anchors_t *, size_t);
+static void anchors_after_insert(list_t *, size_t, node_t *, node_t *);
+static void anchors_after_remove(list_t *, size_t, node_t *, node_t *);
+static node_t *node_alloc(list_t *);
+static node_t *node_alloc_many(list_t *, size_t);
+static void node_free(list_t *, node_t *);
+static size_t node_size(size_t);
+static void *node_data(node_t *);
+static list_val_t node_value(list_t *, node_t *);
+static bool node_holds(list_t *, node_t *, list_val_t);
+static void store_value(list_t *, node_t *, list_val_t);
+static list_pool_t *pool_create(size_t, size_t);
+static bool pool_grow(list_t *, size_t);
+static void pool_release(list_pool_t *);
+static list_pool_t *pool_of(list_t *);
+static void pool_merge(list_pool_t *, list_pool_t *);
+static void move_range(node_t *, node_t *, node_t *, node_t *, node_t *, node_t *);
+static bool splice_compatible(list_t *, list_t *);
+static int move_values(list_t *, size_t, list_t *, size_t, size_t);
+static void list_changed(list_t *);
+static size_t remove_matching(list_t *, element_predicate, void *, element_destructor, bool);
+static void compact_if_churned(list_t *);
+static void reclaimer_start(void);
+static void *reclaimer_run(void *);
+static node_t *unthread(list_t *);
+static void rethread(list_t *, node_t *);
+static node_t *merge_runs(list_t *, node_t *, node_t *, element_comparator);
+static list_val_t replace_value(list_t *, node_t *, list_val_t);
+static size_t hash_slot(list_hash_t *, list_val_t);
+static hash_entry_t *hash_lookup(list_hash_t *, list_val_t);
+static hash_entry_t *hash_entry_of(list_t *, node_t *);
+static void hash_put(list_hash_t *, list_val_t, node_t *, node_t *);
+static void hash_erase(list_hash_t *, hash_entry_t *);
+static bool hash_reserve(list_hash_t *, size_t);
+static void hash_retarget(list_t *, node_t *, node_t *, node_t *);
+static void hash_after_move(list_t *, list_t *, node_t *, node_t *, node_t *, node_t *, node_t *,
+                            node_t *, size_t);
+static void hash_refresh(list_t *);
+#ifdef XORLIST_STATS
+static void stats_walk(list_t *, size_t);
+#endif
 
 /******
  * Exported Functions
@@ -57,20 +271,146 @@ static node_pair_t traverse_to_idx(list_t *, size_t);
  */
 list_t *list_create(void) {
   list_t *list = malloc(sizeof(list_t));
-  node_t *head = malloc(sizeof(node_t));
-  node_t *tail = malloc(sizeof(node_t));
-
-  if (!list || !head || !tail) {
+  if (!list) {
     return nullptr;
   }
 
+  list_init(list);
+
+  return list;
+}
+
+/**
+ * @brief Initialize a list in caller-provided storage
+ *
+ * Sets up a list_t that lives wherever the caller wants it to (on the stack,
+ * in an arena, or inside another struct). Since the head and tail are stored
+ * in the list_t itself, this does not allocate anything. The list can be
+ * used immediately and should be torn down with list_fini(list_t *,
+ * element_destructor).
+ *
+ * The list_t must not be moved or copied until it has been torn down.
+ *
+ * @param list The storage to initialize
+ */
+void list_init(list_t *list) {
+  node_t *head = &list->ends[0];
+  node_t *tail = &list->ends[1];
+
   head->link = calc_new_ptr(nullptr, nullptr, tail);
+  head->value = nullptr;
   tail->link = calc_new_ptr(head, nullptr, nullptr);
+  tail->value = nullptr;
 
   list->head = head;
   list->tail = tail;
 
   list->size = 0;
+  list->elem_size = 0;
+  list->pool = nullptr;
+  list->anchors = nullptr;
+  list->hash = nullptr;
+  list->churn = 0;
+  list->compact_after = 0;
+
+#ifdef XORLIST_STATS
+  list->stats = &list->stats_storage;
+  list_stats_reset(list);
+#endif
+}
+
+/**
+ * @brief Initialize a list backed by a node pool
+ *
+ * Creates a heap-allocated list_t exactly like list_create(void), except that
+ * nodes are carved out of slabs owned by the list rather than allocated one
+ * at a time. Nodes removed from the list are recycled by later insertions, so
+ * a list that stays around the same size (such as a busy queue) stops calling
+ * `malloc(size_t)` and `free(void *)` once it has warmed up. The slabs are
+ * released by list_destroy(list_t *, element_destructor).
+ *
+ * @param slab_nodes The number of nodes to allocate at a time (or 0 for a
+ *        reasonable default)
+ * @return list_t* The new list (or nullptr on failure)
+ */
+list_t *list_create_with_pool(size_t slab_nodes) {
+  list_t *list = list_create();
+  if (!list) {
+    return nullptr;
+  }
+
+  list->pool = pool_create(slab_nodes ? slab_nodes : DEFAULT_SLAB_NODES, node_size(0));
+  if (!list->pool) {
+    list_destroy(list, nullptr);
+    return nullptr;
+  }
+
+  return list;
+}
+
+/**
+ * @brief Initialize a list that stores copies of its values
+ *
+ * Creates a heap-allocated list_t whose elements are `elem_size` bytes each,
+ * stored inside the nodes themselves rather than pointed to. Each element
+ * then costs a single allocation, and reading it doesn't need to follow
+ * another pointer.
+ *
+ * In such a list, every \ref list_val_t passed in points to `elem_size`
+ * bytes that are copied into the list (or is `nullptr` for an element of
+ * all zero bytes), and every \ref list_val_t handed back points to the copy
+ * inside the list, which stays valid until the element is removed. Elements
+ * are compared byte-for-byte, and the element_destructor passed to
+ * list_destroy(list_t *, element_destructor) is given a pointer to each one
+ * before it is freed. Functions that remove an element can't return a
+ * pointer to it, so they return `nullptr`; use list_delete_into(list_t *,
+ * size_t, void *) to copy it out first. Stored elements are aligned for
+ * pointers, so types that need stricter alignment should be copied out with
+ * list_get_into(list_t, size_t, void *) instead of being read in place.
+ *
+ * Values can only be moved between lists with the same element size, and
+ * these lists can't have a hash index.
+ *
+ * @param elem_size The size of each element in bytes (which must not be 0)
+ * @return list_t* The new list (or nullptr on failure)
+ */
+list_t *list_create_inline(size_t elem_size) {
+  if (elem_size == 0) {
+    return nullptr;
+  }
+
+  list_t *list = list_create();
+  if (!list) {
+    return nullptr;
+  }
+
+  list->elem_size = elem_size;
+  return list;
+}
+
+/**
+ * @brief Initialize a list that stores copies of its values in a node pool
+ *
+ * This combines list_create_inline(size_t) with
+ * list_create_with_pool(size_t), so elements are copied into nodes carved out
+ * of slabs and steady-state insertions don't allocate at all.
+ *
+ * @param elem_size The size of each element in bytes (which must not be 0)
+ * @param slab_nodes The number of nodes to allocate at a time (or 0 for a
+ *        reasonable default)
+ * @return list_t* The new list (or nullptr on failure)
+ */
+list_t *list_create_inline_with_pool(size_t elem_size, size_t slab_nodes) {
+  list_t *list = list_create_inline(elem_size);
+  if (!list) {
+    return nullptr;
+  }
+
+  list->pool = pool_create(slab_nodes ? slab_nodes : DEFAULT_SLAB_NODES, node_size(elem_size));
+  if (!list->pool) {
+    list_destroy(list, nullptr);
+    return nullptr;
+  }
 
   return list;
 }
@@ -88,22 +428,178 @@ list_t *list_create(void) {
  * @param destroy A function to properly free list elements (or `nullptr`)
  */
 void list_destroy(list_t *list, element_destructor destroy) {
-  /* Destroy all remaining items in the list. */
-  while (list->size > 0) {
-    list_val_t *item = list_pop(list);
-    if (destroy) {
-      destroy(item);
+  list_fini(list, destroy);
+  free(list);
+}
+
+/**
+ * @brief Deconstruct a list without freeing it
+ *
+ * This is the counterpart to list_init(list_t *): the nodes in the list (and
+ * anything else the list allocated) are torn down exactly as with
+ * list_destroy(list_t *, element_destructor), but the list_t itself is left
+ * to the caller.
+ *
+ * @param list The list to tear down
+ * @param destroy A function to properly free list elements (or `nullptr`)
+ */
+void list_fini(list_t *list, element_destructor destroy) {
+  /* There's no point in keeping the indexes up to date while tearing down. */
+  list_anchors_disable(list);
+  list_hash_disable(list);
+
+  /*
+   * A pool that no other list shares is released whole below, so its nodes
+   * only need visiting if there are values to destroy.
+   */
+  list_pool_t *pool = pool_of(list);
+  bool free_nodes = !pool || pool->refs > 1;
+
+  /*
+   * Walk the list once, destroying each value while fetching the next node
+   * (and the value the destructor will look at next). Each node is freed
+   * one step behind, once the walk no longer needs its address.
+   */
+  if (destroy || free_nodes) {
+    node_t *prev = list->head;
+    node_t *curr = list_next(list->head, nullptr);
+    while (curr != list->tail) {
+      node_t *next = list_next(curr, prev);
+      PREFETCH(next);
+      if (destroy) {
+        if (next != list->tail && !list->elem_size) {
+          PREFETCH(next->value);
+        }
+        destroy(node_value(list, curr));
+      }
+      if (free_nodes && prev != list->head) {
+        node_free(list, prev);
+      }
+      prev = curr;
+      curr = next;
+    }
+    if (free_nodes && prev != list->head) {
+      node_free(list, prev);
     }
   }
+  STATS_ADD(list, removes, list->size);
 
   /* Free memory for list struct members. */
-  free(list->head);
-  free(list->tail);
+  list->size = 0;
   list->head = nullptr;
   list->tail = nullptr;
+  if (list->pool) {
+    pool_release(list->pool);
+    list->pool = nullptr;
+  }
+}
+
+/**
+ * @brief Deconstruct a list on a background thread
+ *
+ * The nodes are moved out of the list in constant time and handed to a
+ * reclaimer thread, which passes each element to destroy and frees the
+ * nodes while the caller carries on. The list itself is freed right away,
+ * so this may only be used on lists made by one of the list_create
+ * functions; use list_fini_async(list_t *, element_destructor) for lists
+ * set up with list_init(list_t *). The list must not be used afterwards,
+ * and destroy must be safe to call from another thread. Since it runs on
+ * the reclaimer thread, destroy must not call
+ * list_destroy_async_wait(void), which would wait forever for the reclaimer
+ * to finish the list it is in the middle of.
+ *
+ * Use list_destroy_async_wait(void) to wait until every list handed off so
+ * far has been torn down.
+ *
+ * @param list The list to tear down
+ * @param destroy A function to properly free list elements (or `nullptr`)
+ */
+void list_destroy_async(list_t *list, element_destructor destroy) {
+  list_fini_async(list, destroy);
   free(list);
 }
 
+/**
+ * @brief Deconstruct a list on a background thread without freeing it
+ *
+ * This is the counterpart to list_init(list_t *): the nodes are handed to
+ * the reclaimer thread exactly as with
+ * list_destroy_async(list_t *, element_destructor), but the list_t itself is
+ * left to the caller, torn down as list_fini(list_t *, element_destructor)
+ * leaves it. Lists that share a pool with another list (see
+ * list_split(list_t *, size_t)), or that can't be handed off, are torn down
+ * right away with list_fini(list_t *, element_destructor).
+ *
+ * @param list The list to tear down
+ * @param destroy A function to properly free list elements (or `nullptr`)
+ */
+void list_fini_async(list_t *list, element_destructor destroy) {
+  list_anchors_disable(list);
+  list_hash_disable(list);
+
+  pthread_once(&reclaimer.once, reclaimer_start);
+  teardown_t *teardown = nullptr;
+  list_pool_t *pool = pool_of(list);
+  if (reclaimer.running && (!pool || pool->refs == 1)) {
+    teardown = malloc(sizeof(teardown_t));
+  }
+  if (!teardown) {
+    list_fini(list, destroy);
+    return;
+  }
+
+  /* Relink the first and last nodes to the new list's head and tail. */
+  list_t *moved = &teardown->list;
+  list_init(moved);
+  if (list->size > 0) {
+    node_t *first = list_next(list->head, nullptr);
+    node_t *last = list_prev(list->tail, nullptr);
+    first->link = calc_new_ptr(first->link, list->head, moved->head);
+    last->link = calc_new_ptr(last->link, list->tail, moved->tail);
+    moved->head->link = first;
+    moved->tail->link = last;
+  }
+  moved->size = list->size;
+  moved->elem_size = list->elem_size;
+  moved->pool = list->pool;
+  teardown->destroy = destroy;
+  teardown->next = nullptr;
+
+  list->size = 0;
+  list->head = nullptr;
+  list->tail = nullptr;
+  list->pool = nullptr;
+
+  pthread_mutex_lock(&reclaimer.lock);
+  if (reclaimer.last) {
+    reclaimer.last->next = teardown;
+  } else {
+    reclaimer.first = teardown;
+  }
+  reclaimer.last = teardown;
+  reclaimer.pending += 1;
+  pthread_cond_signal(&reclaimer.work);
+  pthread_mutex_unlock(&reclaimer.lock);
+}
+
+/**
+ * @brief Wait for lists passed to list_destroy_async(list_t *,
+ * element_destructor) to be torn down
+ *
+ * Returns once every list handed off before (or while) this was called has
+ * had its elements destroyed and its nodes freed. This includes lists passed
+ * to list_fini_async(list_t *, element_destructor). This must not be called
+ * from an element destructor run by the reclaimer: the reclaimer is busy
+ * running it, so the wait would never end.
+ */
+void list_destroy_async_wait(void) {
+  pthread_mutex_lock(&reclaimer.lock);
+  while (reclaimer.pending > 0) {
+    pthread_cond_wait(&reclaimer.done, &reclaimer.lock);
+  }
+  pthread_mutex_unlock(&reclaimer.lock);
+}
+
 /**
  * @brief Add an item to the list at an index.
  *
@@ -118,16 +614,7 @@ int list_insert(list_t *list, size_t idx, list_val_t value) {
     return EXIT_FAILURE;
   }
 
-  /*
-   * If we're working from the back of the list, we need to go one node
-   * further since we substract 1 from the `list->size - idx` calculation
-   * in the traverse_to_idx function.
-   */
-  if (idx > list->size / 2) {
-    return add_at_node(list, value, nodes.curr, list_next(nodes.curr, nodes.prev));
-  }
-
-  return add_at_node(list, value, nodes.prev, nodes.curr);
+  return add_at_node(list, value, nodes.prev, nodes.curr, idx);
 }
 
 /**
@@ -138,7 +625,7 @@ int list_insert(list_t *list, size_t idx, list_val_t value) {
  * @return int A non-zero value on failure
  */
 int list_append(list_t *list, list_val_t value) {
-  return add_at_node(list, value, list_prev(list->tail, nullptr), list->tail);
+  return add_at_node(list, value, list_prev(list->tail, nullptr), list->tail, list->size);
 }
 
 /**
@@ -162,7 +649,7 @@ int list_enqueue(list_t *list, list_val_t value) {
  * @return int A non-zero value on failure
  */
 int list_prepend(list_t *list, list_val_t value) {
-  return add_at_node(list, value, list->head, list_next(list->head, nullptr));
+  return add_at_node(list, value, list->head, list_next(list->head, nullptr), 0);
 }
 
 /**
@@ -178,6 +665,116 @@ int list_push(list_t *list, list_val_t value) {
   return list_prepend(list, value);
 }
 
+/**
+ * @brief Add several items to the list at an index
+ *
+ * The position is found with a single traversal and the nodes are all
+ * allocated up front (carved from at most one new slab for a pooled list),
+ * so this is much cheaper than calling list_insert(list_t *, size_t,
+ * list_val_t) for each item. Either every item is added or none are.
+ *
+ * @param list The list to add the items to
+ * @param idx The index the first item should end up at
+ * @param items The items to add, in order
+ * @param count The number of items
+ * @return int A non-zero value on failure
+ */
+int list_insert_many(list_t *list, size_t idx, const list_val_t *items, size_t count) {
+  if (idx > list->size) {
+    return EXIT_FAILURE;
+  }
+  if (count == 0) {
+    return EXIT_SUCCESS;
+  }
+
+  /* Make sure nothing can fail once the nodes start being linked in. */
+  if (list->hash && !hash_reserve(list->hash, count)) {
+    return EXIT_FAILURE;
+  }
+  node_t *nodes = node_alloc_many(list, count);
+  if (!nodes) {
+    return EXIT_FAILURE;
+  }
+  STATS_ADD(list, inserts, count);
+
+  /*
+   * Appending never moves an anchor, but shifting them after every node
+   * inserted in the middle would be quadratic, so they are left to rebuild.
+   */
+  bool appending = idx == list->size;
+  node_pair_t pair = traverse_to_idx(list, idx);
+  node_t *before = pair.prev;
+  for (size_t i = 0; i < count; i++) {
+    node_t *node = nodes;
+    nodes = node->link;
+
+    store_value(list, node, items[i]);
+    attach_node(list, node, before, pair.curr, appending ? idx + i : UNKNOWN_IDX);
+    before = node;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Add several items to the tail of the list
+ *
+ * This is list_insert_many(list_t *, size_t, const list_val_t *, size_t) at
+ * the end of the list, which doesn't need a traversal at all.
+ *
+ * @param list The list to add the items to
+ * @param items The items to add, in order
+ * @param count The number of items
+ * @return int A non-zero value on failure
+ */
+int list_extend(list_t *list, const list_val_t *items, size_t count) {
+  return list_insert_many(list, list->size, items, count);
+}
+
+/**
+ * @brief Create a list holding the items of an array
+ *
+ * @param items The items to add, in order
+ * @param count The number of items
+ * @return list_t* The new list (or nullptr on failure)
+ */
+list_t *list_from_array(const list_val_t *items, size_t count) {
+  list_t *list = list_create();
+  if (!list) {
+    return nullptr;
+  }
+
+  if (list_extend(list, items, count)) {
+    list_destroy(list, nullptr);
+    return nullptr;
+  }
+
+  return list;
+}
+
+/**
+ * @brief Copy the items of the list into an array
+ *
+ * For a list that stores its values inline, the array is filled with
+ * pointers to the elements, exactly as list_get(list_t, size_t) returns them.
+ *
+ * @param list The list to copy from
+ * @param items Where to store the items
+ * @param max The largest number of items to store
+ * @return size_t The number of items stored
+ */
+size_t list_to_array(list_t list, list_val_t *items, size_t max) {
+  size_t count = list.size < max ? list.size : max;
+
+  node_pair_t nodes = {.prev = list.head, .curr = list_next(list.head, nullptr)};
+  for (size_t i = 0; i < count; i++) {
+    items[i] = node_value(&list, nodes.curr);
+    nodes = walk_forward(nodes, 1);
+  }
+
+  return count;
+}
+
 /**
  * @brief Determine if the list is empty
  *
@@ -199,27 +796,48 @@ bool list_is_empty(list_t list) {
  * @return list_val_t The item at that index (or nullptr for an invalid index)
  */
 list_val_t list_delete(list_t *list, size_t idx) {
+  if (idx >= list->size) {
+    return nullptr;
+  }
+
   node_pair_t nodes = traverse_to_idx(list, idx);
   if (!nodes.prev || !nodes.curr) {
     return nullptr;
   }
 
-  node_t *prev = nodes.prev;
-  node_t *curr = nodes.curr;
-  node_t *next = list_next(curr, prev);
-
-  /* Calculate the new links to nodes. */
-  next->link = calc_new_ptr(prev, curr, next->link);
-  prev->link = calc_new_ptr(prev->link, curr, next);
+  list_val_t val = remove_at_node(list, nodes.prev, nodes.curr, idx);
+  compact_if_churned(list);
+  return val;
+}
 
-  /* Get the value to return. */
-  list_val_t val = curr->value;
+/**
+ * @brief Remove an item from the list at an index, copying it out first
+ *
+ * This is list_delete(list_t *, size_t) for lists created with
+ * list_create_inline(size_t), where the element is copied to `out` before
+ * its node is freed. For other lists, the removed \ref list_val_t itself is
+ * stored at `out`.
+ *
+ * @param list The list to remove from
+ * @param idx The index to remove at
+ * @param out Where to copy the element (or `nullptr` to discard it)
+ * @return int A non-zero value if the index is invalid
+ */
+int list_delete_into(list_t *list, size_t idx, void *out) {
+  if (idx >= list->size) {
+    return EXIT_FAILURE;
+  }
 
-  free(curr);
-  curr = nullptr;
-  list->size -= 1;
+  node_pair_t nodes = traverse_to_idx(list, idx);
+  if (out && list->elem_size) {
+    memcpy(out, node_data(nodes.curr), list->elem_size);
+  } else if (out) {
+    *(list_val_t *)out = nodes.curr->value;
+  }
 
-  return val;
+  remove_at_node(list, nodes.prev, nodes.curr, idx);
+  compact_if_churned(list);
+  return EXIT_SUCCESS;
 }
 
 /**
@@ -263,7 +881,33 @@ list_val_t list_get(list_t list, size_t idx) {
     return nullptr;
   }
 
-  return nodes.curr->value;
+  return node_value(&list, nodes.curr);
+}
+
+/**
+ * @brief Copy the item at an index out of the list
+ *
+ * For lists created with list_create_inline(size_t), the element is copied
+ * to `out`. For other lists, the \ref list_val_t itself is stored at `out`.
+ *
+ * @param list The list to retrieve the item from
+ * @param idx The index to retrieve at
+ * @param out Where to copy the element
+ * @return int A non-zero value if the index is invalid
+ */
+int list_get_into(list_t list, size_t idx, void *out) {
+  if (idx >= list.size) {
+    return EXIT_FAILURE;
+  }
+
+  node_pair_t nodes = traverse_to_idx(&list, idx);
+  if (list.elem_size) {
+    memcpy(out, node_data(nodes.curr), list.elem_size);
+  } else {
+    *(list_val_t *)out = nodes.curr->value;
+  }
+
+  return EXIT_SUCCESS;
 }
 
 /**
@@ -290,15 +934,16 @@ list_val_t list_peek(list_t list) {
  *         is invalid)
  */
 list_val_t list_set(list_t *list, size_t idx, list_val_t value) {
+  if (idx >= list->size) {
+    return nullptr;
+  }
+
   node_pair_t nodes = traverse_to_idx(list, idx);
   if (!nodes.curr) {
     return nullptr;
   }
 
-  list_val_t prior_value = nodes.curr->value;
-  nodes.curr->value = value;
-
-  return prior_value;
+  return replace_value(list, nodes.curr, value);
 }
 
 /**
@@ -318,23 +963,140 @@ size_t list_size(list_t list) {
  * index of the item in the list. It is the responsibility of the caller to
  * ensure the memory for the value is deallocated corrected.
  *
+ * The item is found and unlinked in a single walk. With a hash index, a
+ * value that isn't in the list is rejected without walking at all; use
+ * list_discard(list_t *, list_val_t) when the index isn't needed.
+ *
  * @param list The list to remove the item from
  * @param value The value to remove from the list
  * @return ssize_t The index where the item was previously (or -1 if not found)
  */
 ssize_t list_remove(list_t *list, list_val_t value) {
-  ssize_t idx = list_find(*list, value);
-
-  /*
-   * If the index is invalid, return -1 and don't remove anything.
-   */
-  if (idx > list->size || idx < 0) {
+  if (list->hash && !hash_lookup(list->hash, value)) {
     return -1;
   }
 
-  list_delete(list, idx);
+  STATS_ADD(list, searches, 1);
+  node_pair_t nodes = {.prev = list->head, .curr = list_next(list->head, nullptr)};
+  for (size_t idx = 0; nodes.curr != list->tail; idx++) {
+    if (node_holds(list, nodes.curr, value)) {
+      STATS_WALK(list, idx);
+      remove_at_node(list, nodes.prev, nodes.curr, idx);
+      compact_if_churned(list);
+      return idx;
+    }
+    nodes = walk_forward(nodes, 1);
+  }
 
-  return idx;
+  /* The item does not exist in the list. */
+  STATS_WALK(list, list->size);
+  return -1;
+}
+
+/**
+ * @brief Remove an item from the list by value without finding its index
+ *
+ * With a hash index, this takes constant time and removes one of the
+ * matching items (which is not necessarily the first). Otherwise, it behaves
+ * like list_remove(list_t *, list_val_t).
+ *
+ * @param list The list to remove the item from
+ * @param value The value to remove from the list
+ * @return true If an item was removed
+ * @return false If the value is not in the list
+ */
+bool list_discard(list_t *list, list_val_t value) {
+  if (!list->hash) {
+    return list_remove(list, value) >= 0;
+  }
+
+  hash_entry_t *entry = hash_lookup(list->hash, value);
+  if (!entry) {
+    return false;
+  }
+
+  /* The neighbor may be on either side, which unlinking doesn't care about. */
+  remove_at_node(list, entry->neighbor, entry->node, UNKNOWN_IDX);
+  compact_if_churned(list);
+  return true;
+}
+
+/**
+ * @brief Remove every item of the list that matches a predicate
+ *
+ * Every item is tested once, in order, and the matching ones are unlinked in
+ * the same walk, so this takes linear time however many items are removed.
+ *
+ * @param list The list to remove the items from
+ * @param predicate The function deciding which items to remove
+ * @param ctx A value to pass to every call to predicate
+ * @param destroy A function to properly free removed items (or `nullptr`)
+ * @return size_t The number of items removed
+ */
+size_t list_remove_if(list_t *list, element_predicate predicate, void *ctx,
+                      element_destructor destroy) {
+  return remove_matching(list, predicate, ctx, destroy, true);
+}
+
+/**
+ * @brief Remove every item of the list that doesn't match a predicate
+ *
+ * This is the opposite of list_remove_if(list_t *, element_predicate, void *,
+ * element_destructor), keeping only the matching items.
+ *
+ * @param list The list to remove the items from
+ * @param predicate The function deciding which items to keep
+ * @param ctx A value to pass to every call to predicate
+ * @param destroy A function to properly free removed items (or `nullptr`)
+ * @return size_t The number of items removed
+ */
+size_t list_retain(list_t *list, element_predicate predicate, void *ctx,
+                   element_destructor destroy) {
+  return remove_matching(list, predicate, ctx, destroy, false);
+}
+
+/**
+ * @brief Move an item to the front of the list
+ *
+ * The first matching item (or, with a hash index, any matching item) is
+ * unlinked and linked back in at index 0. The node itself is reused, so this
+ * never allocates. With a hash index, it takes constant time; otherwise it
+ * takes a single walk to find the item.
+ *
+ * @param list The list to modify
+ * @param value The value to move
+ * @return true If the item was moved
+ * @return false If the value is not in the list
+ */
+bool list_move_to_front(list_t *list, list_val_t value) {
+  node_pair_t nodes = {.prev = list->head, .curr = list_next(list->head, nullptr)};
+  size_t idx = 0;
+
+  if (list->hash) {
+    hash_entry_t *entry = hash_lookup(list->hash, value);
+    if (!entry) {
+      return false;
+    }
+    nodes.prev = entry->neighbor;
+    nodes.curr = entry->node;
+    idx = UNKNOWN_IDX;
+  } else {
+    STATS_ADD(list, searches, 1);
+    while (nodes.curr != list->tail && !node_holds(list, nodes.curr, value)) {
+      nodes = walk_forward(nodes, 1);
+      idx++;
+    }
+    STATS_WALK(list, idx);
+    if (nodes.curr == list->tail) {
+      return false;
+    }
+  }
+
+  /* Detaching the node made room for it in the hash index. */
+  detach_node(list, nodes.prev, nodes.curr, idx);
+  attach_node(list, nodes.curr, list->head, list_next(list->head, nullptr), 0);
+
+  return true;
 }
 
 /**
@@ -346,6 +1108,8 @@ ssize_t list_remove(list_t *list, list_val_t value) {
  * @param list The list to reverse
  */
 void list_reverse(list_t *list) {
+  list_changed(list);
+
   list->head = (node_t *)(UNSAFE_PTR_TO_INT(list->head) ^ UNSAFE_PTR_TO_INT(list->tail));
   list->tail = (node_t *)(UNSAFE_PTR_TO_INT(list->head) ^ UNSAFE_PTR_TO_INT(list->tail));
   list->head = (node_t *)(UNSAFE_PTR_TO_INT(list->head) ^ UNSAFE_PTR_TO_INT(list->tail));
@@ -362,13 +1126,23 @@ void list_reverse(list_t *list) {
  * @return ssize_t The index of `value` or -1 if not found
  */
 ssize_t list_find(list_t list, list_val_t value) {
+  if (list.hash && !hash_lookup(list.hash, value)) {
+    return -1;
+  }
+
+  /*
+   * Values are compared by identity, so there's nothing to prefetch, and the
+   * next node can't be found any sooner than by reading the current one.
+   */
   node_t *curr = list_next(list.head, nullptr);
   node_t *prev = list.head;
   size_t idx = 0;
 
   /* Traverse until we find the first node with the value*/
+  STATS_ADD(&list, searches, 1);
   while (curr != list.tail) {
-    if (curr->value == value) {
+    if (node_holds(&list, curr, value)) {
+      STATS_WALK(&list, idx);
       return idx;
     }
     node_t *next_node = list_next(curr, prev);
@@ -378,6 +1152,40 @@ ssize_t list_find(list_t list, list_val_t value) {
   }
 
   /* The item does not exist in the list. */
+  STATS_WALK(&list, idx);
+  return -1;
+}
+
+/**
+ * @brief Find the first item of the list that compares equal to a key
+ *
+ * Unlike list_find(list_t, list_val_t), which compares the values
+ * themselves, this passes each item and the key to a comparator, which will
+ * usually look at what the items point to. The values of upcoming items are
+ * prefetched while earlier ones are being compared (see
+ * \ref XORLIST_PREFETCH_DISTANCE), so those reads overlap with the walk.
+ *
+ * @param list The list to search in
+ * @param key The value to pass as the second argument to cmp
+ * @param cmp The comparator, which returns 0 for a match
+ * @return ssize_t The index of the first match (or -1 if not found)
+ */
+ssize_t list_find_by(list_t list, list_val_t key, element_comparator cmp) {
+  /* Inline values are part of their nodes, which are already being read. */
+  scan_t scan;
+  scan_begin(&scan, &list, list.elem_size == 0);
+  size_t idx = 0;
+
+  STATS_ADD(&list, searches, 1);
+  for (node_t *curr = scan_next(&scan); curr; curr = scan_next(&scan)) {
+    if (cmp(node_value(&list, curr), key) == 0) {
+      STATS_WALK(&list, idx);
+      return idx;
+    }
+    idx++;
+  }
+
+  STATS_WALK(&list, idx);
   return -1;
 }
 
@@ -385,7 +1193,8 @@ ssize_t list_find(list_t list, list_val_t value) {
  * @brief Check if a value exists in the list
  *
  * This does a regular equality comparison by element of the list to see if
- * the given value exists in the list
+ * the given value exists in the list. With a hash index, this takes constant
+ * time.
  *
  * @param list The list to search in
  * @param value The value to search for
@@ -393,111 +1202,1848 @@ ssize_t list_find(list_t list, list_val_t value) {
  * @return false If the value is not found in the list
  */
 bool list_contains(list_t list, list_val_t value) {
-  node_t *curr = list.head;
-  node_t *prev = nullptr;
+  if (list.hash) {
+    return hash_lookup(list.hash, value) != nullptr;
+  }
 
-  while (curr != list.tail) {
-    node_t *next_node = list_next(curr, prev);
-    prev = curr;
-    curr = next_node;
-    if (curr->value == value) {
-      return true;
+  return list_find(list, value) >= 0;
+}
+
+/**
+ * @brief Move every item of one list onto the end of another
+ *
+ * The nodes of `src` are relinked onto the tail of `dst` without being
+ * reallocated, which takes constant time. Afterwards, `src` is empty but can
+ * still be used.
+ *
+ * Nodes are relinked between any two lists created by list_create(void), and
+ * between any two pooled lists: lists with different pools merge them, so
+ * that nodes can keep moving between the two freely (which walks the shorter
+ * of the two lists of free nodes once). An empty list without a pool takes
+ * on the pool of `src`. Only when one list has a pool and the other has
+ * nodes of its own allocated one at a time are the items copied into new
+ * nodes instead. Keep in mind that list_compact(list_t *) (and automatic
+ * compaction, once enabled) gives a list without a pool one.
+ *
+ * @param dst The list to add to
+ * @param src The list to take the items from
+ * @return int A non-zero value on failure
+ */
+int list_concat(list_t *dst, list_t *src) {
+  return list_splice(dst, dst->size, src, 0, src->size);
+}
+
+/**
+ * @brief Move a range of items from one list into another
+ *
+ * The `count` items starting at index `from` in `src` are removed from it and
+ * inserted into `dst` so that the first of them is at index `idx`. Finding
+ * the ends of the range and the insertion point takes one walk each; the
+ * move itself only relinks the nodes at the boundaries.
+ *
+ * Nodes are relinked under the same conditions as for list_concat(list_t *,
+ * list_t *). When the items have to be copied instead, every node is
+ * allocated up front, so on failure neither list is changed.
+ *
+ * If either list has a hash index, each moved item has to be taken out of or
+ * added to it, so the move takes time proportional to `count`.
+ *
+ * @param dst The list to add to
+ * @param idx The index in `dst` to insert at
+ * @param src The list to take the items from (which may not be `dst` and
+ *        must have the same element size)
+ * @param from The index of the first item in `src` to move
+ * @param count The number of items to move
+ * @return int A non-zero value on failure
+ */
+int list_splice(list_t *dst, size_t idx, list_t *src, size_t from, size_t count) {
+  if (dst == src || dst->elem_size != src->elem_size || idx > dst->size || from > src->size ||
+      count > src->size - from) {
+    return EXIT_FAILURE;
+  }
+  if (count == 0) {
+    return EXIT_SUCCESS;
+  }
+  if (!splice_compatible(dst, src)) {
+    return move_values(dst, idx, src, from, count);
+  }
+  if (dst->hash && !hash_reserve(dst->hash, count)) {
+    return EXIT_FAILURE;
+  }
+
+  node_pair_t start = traverse_to_idx(src, from);
+  node_pair_t end = traverse_to_idx(src, from + count);
+  node_pair_t into = traverse_to_idx(dst, idx);
+
+  move_range(start.prev, start.curr, end.prev, end.curr, into.prev, into.curr);
+  if (src->hash || dst->hash) {
+    hash_after_move(dst, src, start.prev, start.curr, end.prev, end.curr, into.prev, into.curr,
+                    count);
+  }
+
+  src->size -= count;
+  dst->size += count;
+  list_changed(src);
+  list_changed(dst);
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Split a list in two at an index
+ *
+ * Every item from `idx` onwards is moved, without reallocation, into a new
+ * list which is returned. The new list allocates nodes the same way the
+ * original one does, so the two can be joined back together with
+ * list_concat(list_t *, list_t *) in constant time.
+ *
+ * @param list The list to split
+ * @param idx The index of the first item to move to the new list
+ * @return list_t* The new list (or nullptr on failure)
+ */
+list_t *list_split(list_t *list, size_t idx) {
+  if (idx > list->size) {
+    return nullptr;
+  }
+
+  list_t *rest = list_create();
+  if (!rest) {
+    return nullptr;
+  }
+
+  rest->elem_size = list->elem_size;
+  rest->pool = pool_of(list);
+  if (rest->pool) {
+    rest->pool->refs += 1;
+  }
+
+  if (list_splice(rest, 0, list, idx, list->size - idx)) {
+    list_destroy(rest, nullptr);
+    return nullptr;
+  }
+
+  return rest;
+}
+
+/**
+ * @brief Sort the list
+ *
+ * This is a stable merge sort that relinks the existing nodes rather than
+ * moving values around, so it takes O(n log n) comparisons and no memory
+ * beyond a small fixed amount of stack.
+ *
+ * @param list The list to sort
+ * @param compare The function that orders two values
+ */
+void list_sort(list_t *list, element_comparator compare) {
+  if (list->size < 2) {
+    return;
+  }
+
+  /*
+   * This is a bottom-up merge sort that works like a binary counter: runs[i]
+   * is either empty or a sorted run of 2^i nodes. Each node is merged into
+   * the runs the same way a carry ripples up through the bits of a number.
+   */
+  node_t *runs[sizeof(size_t) * 8] = {nullptr};
+  size_t max_runs = sizeof(runs) / sizeof(runs[0]);
+  node_t *curr = unthread(list);
+
+  while (curr) {
+    node_t *next = curr->link;
+    curr->link = nullptr;
+
+    /* The nodes already in runs came first, so they go first to stay stable. */
+    node_t *run = curr;
+    size_t i = 0;
+    for (; i < max_runs - 1 && runs[i]; i++) {
+      run = merge_runs(list, runs[i], run, compare);
+      runs[i] = nullptr;
     }
+    runs[i] = run;
+
+    curr = next;
   }
 
-  /* The item does not exist in the list. */
-  return false;
+  /* Merge what's left, from the latest nodes to the earliest. */
+  node_t *sorted = nullptr;
+  for (size_t i = 0; i < max_runs; i++) {
+    if (runs[i]) {
+      sorted = sorted ? merge_runs(list, runs[i], sorted, compare) : runs[i];
+    }
+  }
+
+  rethread(list, sorted);
 }
 
-/*****
- * Utility Functions
- *****/
+/**
+ * @brief Add an item to a sorted list, keeping it sorted
+ *
+ * The item is added after any items that compare equal to it.
+ *
+ * @param list The sorted list to add to
+ * @param value The value to add
+ * @param compare The function the list is ordered by
+ * @return int A non-zero value on failure
+ */
+int list_insert_sorted(list_t *list, list_val_t value, element_comparator compare) {
+  list_cursor_t cursor = list_cursor_begin(list);
+  while (list_cursor_valid(cursor) && compare(list_cursor_get(cursor), value) <= 0) {
+    list_cursor_next(&cursor);
+  }
+
+  return list_cursor_insert_before(&cursor, value);
+}
 
 /**
- * Calculates the new link for a node. Useful for insertions and removals.
+ * @brief Merge one sorted list into another
+ *
+ * Every item of `src` is moved into `dst` so that `dst` remains sorted. When
+ * items compare equal, those from `dst` come first. The nodes are relinked
+ * where possible, subject to the same restrictions as list_concat(list_t *,
+ * list_t *). Afterwards, `src` is empty but can still be used.
+ *
+ * @param dst The sorted list to merge into
+ * @param src The sorted list to take the items from
+ * @param compare The function both lists are ordered by
+ * @return int A non-zero value on failure
  */
-static node_t *calc_new_ptr(void *a, void *b, void *c) {
-  return (node_t *)(UNSAFE_PTR_TO_INT(a) ^ UNSAFE_PTR_TO_INT(b) ^ UNSAFE_PTR_TO_INT(c));
+int list_merge_sorted(list_t *dst, list_t *src, element_comparator compare) {
+  size_t count = dst->size;
+
+  if (list_concat(dst, src)) {
+    return EXIT_FAILURE;
+  }
+  if (count == 0 || count == dst->size) {
+    return EXIT_SUCCESS;
+  }
+
+  /* Cut the chain where the nodes from src begin and merge the two halves. */
+  node_t *first = unthread(dst);
+  node_t *last = first;
+  for (size_t i = 1; i < count; i++) {
+    last = last->link;
+  }
+  node_t *second = last->link;
+  last->link = nullptr;
+
+  rethread(dst, merge_runs(dst, first, second, compare));
+
+  return EXIT_SUCCESS;
 }
 
 /**
- * Returns the next item in the list after curr.
+ * @brief Keep an index of anchors into the list
+ *
+ * Every `spacing` elements, the list remembers where it is so that
+ * positional access (list_get(list_t, size_t), list_set(list_t *, size_t,
+ * list_val_t), list_insert(list_t *, size_t, list_val_t),
+ * list_delete(list_t *, size_t) and list_cursor_at(list_t *, size_t)) can
+ * start walking from the nearest anchor instead of from an end of the list.
+ * A lookup then takes at most `spacing / 2` steps, at the cost of two
+ * pointers of memory per anchor and of shifting up to `size / spacing`
+ * anchors on every insertion and removal. A spacing near the square root of
+ * the expected size balances the two.
+ *
+ * Enabling the anchors on a list that already has them changes the spacing.
+ *
+ * @param list The list to index
+ * @param spacing The number of elements between anchors
+ * @return int A non-zero value on failure
  */
-static node_t *list_next(node_t *curr, node_t *prev) {
-  return calc_new_ptr(prev, curr->link, nullptr);
+int list_anchors_enable(list_t *list, size_t spacing) {
+  if (spacing == 0) {
+    return EXIT_FAILURE;
+  }
+
+  if (!list->anchors) {
+    list->anchors = malloc(sizeof(list_anchors_t));
+    if (!list->anchors) {
+      return EXIT_FAILURE;
+    }
+    list->anchors->pairs = nullptr;
+    list->anchors->capacity = 0;
+  }
+
+  /* The anchors are built on first use. */
+  list->anchors->count = 0;
+  list->anchors->spacing = spacing;
+  list->anchors->stale = true;
+
+  return EXIT_SUCCESS;
 }
 
 /**
- * Returns the previous item in the list before curr.
+ * @brief Stop keeping an index of anchors into the list
+ *
+ * @param list The list to stop indexing
  */
-static node_t *list_prev(node_t *curr, node_t *next) {
-  return calc_new_ptr(nullptr, curr->link, next);
+void list_anchors_disable(list_t *list) {
+  if (!list->anchors) {
+    return;
+  }
+
+  free(list->anchors->pairs);
+  free(list->anchors);
+  list->anchors = nullptr;
 }
 
 /**
- * Add a node with a given value between two given nodes.
+ * @brief Keep a hash index of the values in the list
+ *
+ * The index maps each value to the nodes holding it, so that
+ * list_contains(list_t, list_val_t) and list_discard(list_t *, list_val_t)
+ * take constant time, and list_find(list_t, list_val_t) and
+ * list_remove(list_t *, list_val_t) give up on a missing value straight
+ * away. Values are compared by identity, as everywhere else.
+ *
+ * Keeping the index costs six to twelve pointers of memory per element and a
+ * hash table update on every insertion, removal and change of value. Copies
+ * of the same value land in the same probe sequence, so the index works best
+ * when values are mostly distinct.
+ *
+ * Enabling the index on a list that already has one does nothing. Lists
+ * created with list_create_inline(size_t) can't have one.
+ *
+ * @param list The list to index
+ * @return int A non-zero value on failure
  */
-static int add_at_node(list_t *list, list_val_t value, node_t *before, node_t *after) {
-  /* Allocate and initialize the new node. */
-  node_t *new_node = malloc(sizeof(node_t));
-  if (!new_node) {
+int list_hash_enable(list_t *list) {
+  if (list->hash) {
+    return EXIT_SUCCESS;
+  }
+  if (list->elem_size) {
     return EXIT_FAILURE;
   }
 
-  new_node->value = value;
+  list_hash_t *hash = malloc(sizeof(list_hash_t));
+  if (!hash) {
+    return EXIT_FAILURE;
+  }
+  hash->entries = nullptr;
+  hash->count = 0;
+  hash->capacity = 0;
 
-  /* Set the pointers to surrounding nodes. */
-  new_node->link = calc_new_ptr(before, nullptr, after);
-  after->link = calc_new_ptr(before, new_node, after->link);
-  before->link = calc_new_ptr(before->link, new_node, after);
+  if (!hash_reserve(hash, list->size)) {
+    free(hash);
+    return EXIT_FAILURE;
+  }
 
-  list->size += 1;
+  node_t *prev = list->head;
+  node_t *curr = list_next(list->head, nullptr);
+  while (curr != list->tail) {
+    hash_put(hash, curr->value, curr, prev);
+    node_t *next = list_next(curr, prev);
+    prev = curr;
+    curr = next;
+  }
 
+  list->hash = hash;
   return EXIT_SUCCESS;
 }
 
 /**
- * Traverses the list and returns the node at the specified index. This is
- * only useful when the index is actually known.
+ * @brief Stop keeping a hash index of the values in the list
+ *
+ * @param list The list to stop indexing
  */
-static node_pair_t traverse_to_idx(list_t *list, size_t idx) {
-  node_t *starting_end;
-  size_t num_iter;
+void list_hash_disable(list_t *list) {
+  if (!list->hash) {
+    return;
+  }
 
-  /*
-   * If the index isn't valid, don't bother searching at all.
-   */
-  if (idx > list->size) {
-    node_pair_t all_null = {.prev = nullptr, .curr = nullptr};
-    return all_null;
+  free(list->hash->entries);
+  free(list->hash);
+  list->hash = nullptr;
+}
+
+/**
+ * @brief Move the nodes of a list into one contiguous block, in list order
+ *
+ * After a lot of churn, consecutive nodes end up scattered across memory and
+ * every step of a traversal is likely a cache miss. This copies every node
+ * into a single fresh slab in the order they appear in the list and rewrites
+ * the links, so later traversals walk memory sequentially. The old nodes are
+ * released; nodes of a pool shared with split lists go back to that pool.
+ *
+ * The list keeps the fresh slab as its node pool from then on (see
+ * list_create_with_pool(size_t)), even if it didn't have one before. Nodes
+ * keep being relinked when splicing with other pooled lists, but a list that
+ * had no pool can no longer swap nodes with non-empty lists created by
+ * list_create(void): list_concat(list_t *, list_t *) and
+ * list_splice(list_t *, size_t, list_t *, size_t, size_t) copy the items
+ * between the two instead. Cursors on the list are invalidated.
+ *
+ * @param list The list to compact
+ * @return int A non-zero value on failure, in which case the list is
+ *         unchanged
+ */
+int list_compact(list_t *list) {
+  list_pool_t *old = pool_of(list);
+  list_pool_t *pool = pool_create(old ? old->slab_nodes : DEFAULT_SLAB_NODES,
+                                  node_size(list->elem_size));
+  if (!pool) {
+    return EXIT_FAILURE;
+  }
+
+  list->pool = pool;
+  if (list->size > 0 && !pool_grow(list, list->size)) {
+    list->pool = old;
+    pool_release(pool);
+    return EXIT_FAILURE;
   }
 
   /*
-   * Search from the end of the list for indexes after halfway.
+   * Each copy is linked to the copy before it right away; its link to the
+   * copy after it is XORed in once that copy exists.
    */
-  if (idx <= list->size / 2) {
-    starting_end = list->head;
-    num_iter = idx;
-  } else {
-    starting_end = list->tail;
-    /*
-     * Subtrace one so to fix index calculations for accesses. This does
-     * present a small issue when adding new nodes, but it's a simple
-     * workaround.
-     */
-    num_iter = list->size - idx - 1;
-  }
+  size_t bytes = node_size(list->elem_size);
+  node_t *prev = list->head;
+  node_t *curr = list_next(list->head, nullptr);
+  node_t *before = list->head;
+  while (curr != list->tail) {
+    node_t *next = list_next(curr, prev);
+    node_t *node = node_alloc(list);
+    memcpy(node, curr, bytes);
+    node->link = before;
+    before->link = before == list->head ? node : calc_new_ptr(before->link, nullptr, node);
+
+    hash_entry_t *entry = hash_entry_of(list, curr);
+    if (entry) {
+      entry->node = node;
+      entry->neighbor = before;
+    }
 
-  /* Start traversing from the end until the needed index. */
-  node_t *curr = list_next(starting_end, nullptr);
-  node_t *prev = starting_end;
+    if (old) {
+      curr->link = old->free;
+      old->free = curr;
+      old->available += 1;
+    } else {
+      STATS_ADD(list, frees, 1);
+      free(curr);
+    }
 
-  for (int i = 0; i < num_iter; i++) {
-    node_t *tmp = list_next(curr, prev);
+    before = node;
     prev = curr;
-    curr = tmp;
+    curr = next;
   }
 
-  node_pair_t result = {.prev = prev, .curr = curr};
-  return result;
+  /* Close the list off at the tail. */
+  before->link =
+      before == list->head ? list->tail : calc_new_ptr(before->link, nullptr, list->tail);
+  list->tail->link = before;
+  if (old) {
+    pool_release(old);
+  }
+
+  list->churn = 0;
+  list_changed(list);
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Compact a list automatically after enough removals
+ *
+ * Once the given number of nodes have been removed since the last
+ * compaction, the next call to list_delete(list_t *, size_t),
+ * list_delete_into(list_t *, size_t, void *), list_remove(list_t *,
+ * list_val_t), list_discard(list_t *, list_val_t) or one of the bulk removal
+ * functions ends with list_compact(list_t *). Removals through a cursor never
+ * trigger it, since that would invalidate the cursor.
+ *
+ * A list without a pool is compacted right away to give it one, so the way
+ * its nodes are allocated (and with it, which lists it can splice with
+ * without copying; see list_concat(list_t *, list_t *)) changes here rather
+ * than at some later removal. If that fails, the list isn't compacted
+ * automatically.
+ *
+ * @param list The list to compact
+ * @param removals The number of removals between compactions (or 0 to stop
+ *        compacting automatically)
+ */
+void list_compact_auto(list_t *list, size_t removals) {
+  list->compact_after = removals;
+  if (removals && !list->pool) {
+    list_compact(list);
+  }
+}
+
+/**
+ * @brief Get statistics about how the list has been used
+ *
+ * Statistics are only gathered when xorlist is built with `XORLIST_STATS`
+ * defined (which must also be defined wherever list.h is included).
+ * Otherwise, this clears `stats` and fails, and gathering them costs
+ * nothing. The counts cover everything since the list was created or
+ * list_stats_reset(list_t *) was last called; `bytes` is measured at the
+ * time of the call.
+ *
+ * @param list The list to report on
+ * @param stats Where to store the statistics
+ * @return int A non-zero value if statistics aren't being gathered
+ */
+int list_stats(list_t *list, struct list_stats *stats) {
+  memset(stats, 0, sizeof(struct list_stats));
+
+#ifdef XORLIST_STATS
+  *stats = *list->stats;
+
+  size_t bytes = 0;
+  list_pool_t *pool = pool_of(list);
+  if (pool) {
+    /* A pool shared with other lists is counted in full for each of them. */
+    for (slab_t *slab = pool->slabs; slab; slab = slab->next) {
+      bytes += sizeof(slab_t) + slab->count * pool->node_size;
+    }
+    bytes += sizeof(list_pool_t);
+  } else {
+    bytes += list->size * node_size(list->elem_size);
+  }
+  if (list->anchors) {
+    bytes += sizeof(list_anchors_t) + list->anchors->capacity * sizeof(node_pair_t);
+  }
+  if (list->hash) {
+    bytes += sizeof(list_hash_t) + list->hash->capacity * sizeof(hash_entry_t);
+  }
+  stats->bytes = bytes;
+
+  return EXIT_SUCCESS;
+#else
+  (void)list;
+  return EXIT_FAILURE;
+#endif
+}
+
+/**
+ * @brief Start gathering statistics about the list afresh
+ *
+ * This does nothing unless xorlist is built with `XORLIST_STATS`.
+ *
+ * @param list The list to reset the statistics of
+ */
+void list_stats_reset(list_t *list) {
+#ifdef XORLIST_STATS
+  memset(list->stats, 0, sizeof(struct list_stats));
+#else
+  (void)list;
+#endif
+}
+
+/******
+ * Cursor Functions
+ ******/
+
+/**
+ * @brief Get a cursor on the first element of a list
+ *
+ * If the list is empty, the cursor will be on the tail.
+ *
+ * @param list The list to traverse
+ * @return list_cursor_t A cursor at index 0
+ */
+list_cursor_t list_cursor_begin(list_t *list) {
+  list_cursor_t cursor = {
+      .list = list,
+      .prev = list->head,
+      .curr = list_next(list->head, nullptr),
+      .idx = 0,
+  };
+  return cursor;
+}
+
+/**
+ * @brief Get a cursor on the last element of a list
+ *
+ * If the list is empty, the cursor will be on the head.
+ *
+ * @param list The list to traverse
+ * @return list_cursor_t A cursor at the last index
+ */
+list_cursor_t list_cursor_end(list_t *list) {
+  node_t *curr = list_prev(list->tail, nullptr);
+  list_cursor_t cursor = {
+      .list = list,
+      .prev = list_prev(curr, list->tail),
+      .curr = curr,
+      .idx = (ssize_t)list->size - 1,
+  };
+  return cursor;
+}
+
+/**
+ * @brief Get a cursor on the element at an index
+ *
+ * This walks the list once from whichever end is closer. An index at or past
+ * the end of the list gives a cursor on the tail.
+ *
+ * @param list The list to traverse
+ * @param idx The index to start at
+ * @return list_cursor_t A cursor at the index
+ */
+list_cursor_t list_cursor_at(list_t *list, size_t idx) {
+  if (idx > list->size) {
+    idx = list->size;
+  }
+
+  node_pair_t nodes = traverse_to_idx(list, idx);
+  list_cursor_t cursor = {
+      .list = list,
+      .prev = nodes.prev,
+      .curr = nodes.curr,
+      .idx = (ssize_t)idx,
+  };
+  return cursor;
+}
+
+/**
+ * @brief Determine if a cursor is on an element
+ *
+ * @param cursor The cursor
+ * @return true If the cursor is on an element of the list
+ * @return false If the cursor is on the head or tail of the list
+ */
+bool list_cursor_valid(list_cursor_t cursor) {
+  return !is_sentinel(cursor.list, cursor.curr);
+}
+
+/**
+ * @brief Move a cursor to the next element
+ *
+ * A cursor on the tail does not move.
+ *
+ * @param cursor The cursor to move
+ * @return true If the cursor is now on an element
+ * @return false If the cursor is now on the tail
+ */
+bool list_cursor_next(list_cursor_t *cursor) {
+  if (cursor->curr == cursor->list->tail) {
+    return false;
+  }
+
+  node_t *next = list_next(cursor->curr, cursor->prev);
+  cursor->prev = cursor->curr;
+  cursor->curr = next;
+  cursor->idx += 1;
+
+  return cursor->curr != cursor->list->tail;
+}
+
+/**
+ * @brief Move a cursor to the previous element
+ *
+ * A cursor on the head does not move.
+ *
+ * @param cursor The cursor to move
+ * @return true If the cursor is now on an element
+ * @return false If the cursor is now on the head
+ */
+bool list_cursor_prev(list_cursor_t *cursor) {
+  if (cursor->curr == cursor->list->head) {
+    return false;
+  }
+
+  node_t *prev = list_prev(cursor->prev, cursor->curr);
+  cursor->curr = cursor->prev;
+  cursor->prev = prev;
+  cursor->idx -= 1;
+
+  return cursor->curr != cursor->list->head;
+}
+
+/**
+ * @brief Get the value under a cursor
+ *
+ * @param cursor The cursor
+ * @return list_val_t The value (or nullptr if not on an element)
+ */
+list_val_t list_cursor_get(list_cursor_t cursor) {
+  if (!list_cursor_valid(cursor)) {
+    return nullptr;
+  }
+
+  return node_value(cursor.list, cursor.curr);
+}
+
+/**
+ * @brief Change the value under a cursor
+ *
+ * @param cursor The cursor
+ * @param value The new value to set
+ * @return list_val_t The previous value (or nullptr if not on an element)
+ */
+list_val_t list_cursor_set(list_cursor_t *cursor, list_val_t value) {
+  if (!list_cursor_valid(*cursor)) {
+    return nullptr;
+  }
+
+  return replace_value(cursor->list, cursor->curr, value);
+}
+
+/**
+ * @brief Add an item in front of the cursor
+ *
+ * The cursor stays on the same node, whose index increases by one. Inserting
+ * on the tail appends to the list.
+ *
+ * @param cursor The cursor to insert at
+ * @param value The value to add
+ * @return int A non-zero value on failure (including a cursor on the head)
+ */
+int list_cursor_insert_before(list_cursor_t *cursor, list_val_t value) {
+  if (cursor->curr == cursor->list->head) {
+    return EXIT_FAILURE;
+  }
+
+  node_t *new_node = link_node(cursor->list, value, cursor->prev, cursor->curr, cursor->idx);
+  if (!new_node) {
+    return EXIT_FAILURE;
+  }
+
+  cursor->prev = new_node;
+  cursor->idx += 1;
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Add an item after the cursor
+ *
+ * The cursor does not move. Inserting on the head prepends to the list.
+ *
+ * @param cursor The cursor to insert at
+ * @param value The value to add
+ * @return int A non-zero value on failure (including a cursor on the tail)
+ */
+int list_cursor_insert_after(list_cursor_t *cursor, list_val_t value) {
+  if (cursor->curr == cursor->list->tail) {
+    return EXIT_FAILURE;
+  }
+
+  node_t *next = list_next(cursor->curr, cursor->prev);
+  return add_at_node(cursor->list, value, cursor->curr, next, cursor->idx + 1);
+}
+
+/**
+ * @brief Remove the item under the cursor
+ *
+ * The cursor moves on to the next element (or the tail).
+ *
+ * @param cursor The cursor to remove at
+ * @return list_val_t The removed value (or nullptr if not on an element)
+ */
+list_val_t list_cursor_delete(list_cursor_t *cursor) {
+  if (!list_cursor_valid(*cursor)) {
+    return nullptr;
+  }
+
+  node_t *next = list_next(cursor->curr, cursor->prev);
+  list_val_t value = remove_at_node(cursor->list, cursor->prev, cursor->curr, cursor->idx);
+  cursor->curr = next;
+
+  return value;
+}
+
+/*****
+ * Utility Functions
+ *****/
+
+/**
+ * Calculates the new link for a node. Useful for insertions and removals.
+ */
+static node_t *calc_new_ptr(void *a, void *b, void *c) {
+  return (node_t *)(UNSAFE_PTR_TO_INT(a) ^ UNSAFE_PTR_TO_INT(b) ^ UNSAFE_PTR_TO_INT(c));
+}
+
+/**
+ * Returns the next item in the list after curr.
+ */
+static node_t *list_next(node_t *curr, node_t *prev) {
+  return calc_new_ptr(prev, curr->link, nullptr);
+}
+
+/**
+ * Returns the previous item in the list before curr.
+ */
+static node_t *list_prev(node_t *curr, node_t *next) {
+  return calc_new_ptr(nullptr, curr->link, next);
+}
+
+/**
+ * Add a node with a given value between two given nodes.
+ */
+static int add_at_node(list_t *list, list_val_t value, node_t *before, node_t *after, size_t idx) {
+  return link_node(list, value, before, after, idx) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Link a new node with a given value between two given nodes, returning the
+ * new node (or nullptr if it could not be allocated). The index the new node
+ * ends up at is used to keep the anchors up to date; pass UNKNOWN_IDX if it
+ * isn't known.
+ */
+static node_t *link_node(list_t *list, list_val_t value, node_t *before, node_t *after,
+                         size_t idx) {
+  /* Make sure the hash index can't fail once the node is linked in. */
+  if (list->hash && !hash_reserve(list->hash, 1)) {
+    return nullptr;
+  }
+
+  /* Allocate and initialize the new node. */
+  node_t *new_node = node_alloc(list);
+  if (!new_node) {
+    return nullptr;
+  }
+  STATS_ADD(list, inserts, 1);
+
+  store_value(list, new_node, value);
+  attach_node(list, new_node, before, after, idx);
+
+  return new_node;
+}
+
+/**
+ * Link an existing node in between two given nodes. The hash index, if
+ * there is one, must have room for the node.
+ */
+static void attach_node(list_t *list, node_t *node, node_t *before, node_t *after, size_t idx) {
+  /* Set the pointers to surrounding nodes. */
+  node->link = calc_new_ptr(before, nullptr, after);
+  after->link = calc_new_ptr(before, node, after->link);
+  before->link = calc_new_ptr(before->link, node, after);
+
+  list->size += 1;
+  anchors_after_insert(list, idx, before, node);
+  if (list->hash) {
+    hash_put(list->hash, node->value, node, before);
+    hash_retarget(list, before, after, node);
+    hash_retarget(list, after, before, node);
+  }
+}
+
+/**
+ * Remove the node between prev and the node after it, returning its value.
+ * As with link_node, idx is the index of the node (or UNKNOWN_IDX).
+ */
+static list_val_t remove_at_node(list_t *list, node_t *prev, node_t *curr, size_t idx) {
+  detach_node(list, prev, curr, idx);
+
+  /* Get the value to return, which can't outlive an inline node. */
+  list_val_t val = list->elem_size ? nullptr : curr->value;
+
+  node_free(list, curr);
+  list->churn += 1;
+  STATS_ADD(list, removes, 1);
+
+  return val;
+}
+
+/**
+ * Unlink the node between prev and the node after it without freeing it.
+ */
+static void detach_node(list_t *list, node_t *prev, node_t *curr, size_t idx) {
+  node_t *next = list_next(curr, prev);
+
+  /* Calculate the new links to nodes. */
+  next->link = calc_new_ptr(prev, curr, next->link);
+  prev->link = calc_new_ptr(prev->link, curr, next);
+
+  if (list->hash) {
+    hash_erase(list->hash, hash_entry_of(list, curr));
+    hash_retarget(list, prev, curr, next);
+    hash_retarget(list, next, curr, prev);
+  }
+
+  list->size -= 1;
+  anchors_after_remove(list, idx, prev, next);
+}
+
+/**
+ * Determines whether a node is the head or tail of the list.
+ */
+static bool is_sentinel(list_t *list, node_t *node) {
+  return node == list->head || node == list->tail;
+}
+
+/**
+ * Traverses the list and returns the node at the specified index along with
+ * the node before it. An index equal to the size of the list yields the tail
+ * as the current node, which is where an append would be linked in.
+ */
+static node_pair_t traverse_to_idx(list_t *list, size_t idx) {
+  /*
+   * If the index isn't valid, don't bother searching at all.
+   */
+  if (idx > list->size) {
+    node_pair_t all_null = {.prev = nullptr, .curr = nullptr};
+    return all_null;
+  }
+
+  /* Start from whichever end of the list is closer. */
+  node_pair_t start = {.prev = list->head, .curr = list_next(list->head, nullptr)};
+  size_t start_idx = 0;
+  if (list->size - idx < idx) {
+    start.prev = list_prev(list->tail, nullptr);
+    start.curr = list->tail;
+    start_idx = list->size;
+  }
+
+  /*
+   * Anchors closer than that are better still. Only the anchors on either
+   * side of the index need to be considered; anchor j sits at index
+   * (j + 1) * spacing.
+   */
+  list_anchors_t *anchors = list->anchors;
+  if (anchors && (!anchors->stale || anchors_rebuild(list))) {
+    size_t below = idx / anchors->spacing;
+    for (size_t j = below; j <= below + 1; j++) {
+      size_t anchor_idx = j * anchors->spacing;
+      if (j == 0 || j > anchors->count ||
+          index_distance(anchor_idx, idx) >= index_distance(start_idx, idx)) {
+        continue;
+      }
+      start = anchors->pairs[j - 1];
+      start_idx = anchor_idx;
+    }
+  }
+
+  STATS_ADD(list, lookups, 1);
+  STATS_WALK(list, index_distance(start_idx, idx));
+
+  if (start_idx <= idx) {
+    return walk_forward(start, idx - start_idx);
+  }
+  return walk_backward(start, start_idx - idx);
+}
+
+/**
+ * The number of steps between two indexes.
+ */
+static size_t index_distance(size_t a, size_t b) {
+  return a > b ? a - b : b - a;
+}
+
+/**
+ * Moves a pair of nodes forward by a number of steps.
+ */
+static node_pair_t walk_forward(node_pair_t nodes, size_t steps) {
+  node_t *prev = nodes.prev;
+  node_t *curr = nodes.curr;
+
+  for (size_t i = 0; i < steps; i++) {
+    node_t *tmp = list_next(curr, prev);
+    prev = curr;
+    curr = tmp;
+  }
+
+  node_pair_t result = {.prev = prev, .curr = curr};
+  return result;
+}
+
+/**
+ * Moves a pair of nodes backward by a number of steps.
+ */
+static node_pair_t walk_backward(node_pair_t nodes, size_t steps) {
+  node_t *prev = nodes.prev;
+  node_t *curr = nodes.curr;
+
+  for (size_t i = 0; i < steps; i++) {
+    node_t *tmp = list_prev(prev, curr);
+    curr = prev;
+    prev = tmp;
+  }
+
+  node_pair_t result = {.prev = prev, .curr = curr};
+  return result;
+}
+
+/**
+ * Starts a scan at the first node of the list, prefetching the values of
+ * the nodes found ahead if values is set.
+ */
+static void scan_begin(scan_t *scan, list_t *list, bool values) {
+  scan->list = list;
+  scan->ahead.prev = list->head;
+  scan->ahead.curr = list_next(list->head, nullptr);
+  scan->first = 0;
+  scan->count = 0;
+  scan->values = values && XORLIST_PREFETCH_DISTANCE > 0;
+}
+
+/**
+ * Hands out the next node of a scan (or nullptr once it reaches the tail),
+ * after topping up the nodes found ahead of it.
+ */
+static node_t *scan_next(scan_t *scan) {
+  while (scan->count < SCAN_WINDOW && scan->ahead.curr != scan->list->tail) {
+    node_t *node = scan->ahead.curr;
+    if (scan->values) {
+      PREFETCH(node->value);
+    }
+    scan->window[(scan->first + scan->count) % SCAN_WINDOW] = node;
+    scan->count += 1;
+    scan->ahead = walk_forward(scan->ahead, 1);
+  }
+
+  if (scan->count == 0) {
+    return nullptr;
+  }
+
+  node_t *node = scan->window[scan->first];
+  scan->first = (scan->first + 1) % SCAN_WINDOW;
+  scan->count -= 1;
+  return node;
+}
+
+/**
+ * Allocates a node for the list, either from its pool or from the heap.
+ */
+static node_t *node_alloc(list_t *list) {
+  list_pool_t *pool = pool_of(list);
+  if (!pool) {
+    STATS_ADD(list, allocs, 1);
+    return malloc(node_size(list->elem_size));
+  }
+
+  if (!pool->free && !pool_grow(list, pool->slab_nodes)) {
+    return nullptr;
+  }
+
+  node_t *node = pool->free;
+  pool->free = node->link;
+  pool->available -= 1;
+  return node;
+}
+
+/**
+ * Gets count nodes at once, chained together through their link fields and
+ * ending in nullptr. A pool makes room for all of them with at most one new
+ * slab. Either every node is allocated or none are.
+ */
+static node_t *node_alloc_many(list_t *list, size_t count) {
+  list_pool_t *pool = pool_of(list);
+  if (pool) {
+    if (pool->available < count) {
+      size_t missing = count - pool->available;
+      if (!pool_grow(list, missing > pool->slab_nodes ? missing : pool->slab_nodes)) {
+        return nullptr;
+      }
+    }
+
+    node_t *first = pool->free;
+    node_t *last = first;
+    for (size_t i = 1; i < count; i++) {
+      last = last->link;
+    }
+    pool->free = last->link;
+    pool->available -= count;
+    last->link = nullptr;
+    return first;
+  }
+
+  node_t *chain = nullptr;
+  for (size_t i = 0; i < count; i++) {
+    node_t *node = malloc(node_size(list->elem_size));
+    if (!node) {
+      while (chain) {
+        node_t *next = chain->link;
+        free(chain);
+        chain = next;
+      }
+      return nullptr;
+    }
+    node->link = chain;
+    chain = node;
+  }
+  STATS_ADD(list, allocs, count);
+
+  return chain;
+}
+
+/**
+ * Returns a node to wherever node_alloc(list_t *) got it from.
+ */
+static void node_free(list_t *list, node_t *node) {
+  list_pool_t *pool = pool_of(list);
+  if (!pool) {
+    STATS_ADD(list, frees, 1);
+    free(node);
+    return;
+  }
+
+  node->link = pool->free;
+  pool->free = node;
+  pool->available += 1;
+}
+
+/**
+ * The number of bytes in a node holding a value of the given size inline (or
+ * a pointer, for 0). The value starts where node_t's value field does.
+ */
+static size_t node_size(size_t elem_size) {
+  size_t size = offsetof(node_t, value) + (elem_size ? elem_size : sizeof(list_val_t));
+  size_t align = alignof(node_t);
+  return (size + align - 1) / align * align;
+}
+
+/**
+ * Where a value stored inline in a node begins.
+ */
+static void *node_data(node_t *node) {
+  return (unsigned char *)node + offsetof(node_t, value);
+}
+
+/**
+ * The value of a node as it is handed out by the list: the pointer it holds,
+ * or where an inline value is stored.
+ */
+static list_val_t node_value(list_t *list, node_t *node) {
+  return list->elem_size ? node_data(node) : node->value;
+}
+
+/**
+ * Whether a node holds a value, as passed in to the list.
+ */
+static bool node_holds(list_t *list, node_t *node, list_val_t value) {
+  if (!list->elem_size) {
+    return node->value == value;
+  }
+  if (!value) {
+    /* A nullptr value stands for all zero bytes. */
+    unsigned char *data = node_data(node);
+    for (size_t i = 0; i < list->elem_size; i++) {
+      if (data[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return memcmp(node_data(node), value, list->elem_size) == 0;
+}
+
+/**
+ * Stores a value, as passed in to the list, in a node.
+ */
+static void store_value(list_t *list, node_t *node, list_val_t value) {
+  if (!list->elem_size) {
+    node->value = value;
+  } else if (value) {
+    memcpy(node_data(node), value, list->elem_size);
+  } else {
+    memset(node_data(node), 0, list->elem_size);
+  }
+}
+
+/**
+ * Creates an empty pool of nodes of the given size. No slabs are allocated
+ * until the first node is needed.
+ */
+static list_pool_t *pool_create(size_t slab_nodes, size_t node_size) {
+  list_pool_t *pool = malloc(sizeof(list_pool_t));
+  if (!pool) {
+    return nullptr;
+  }
+
+  pool->slabs = nullptr;
+  pool->last_slab = nullptr;
+  pool->free = nullptr;
+  pool->available = 0;
+  pool->slab_nodes = slab_nodes;
+  pool->node_size = node_size;
+  pool->refs = 1;
+  pool->merged = nullptr;
+
+  return pool;
+}
+
+/**
+ * Adds a slab of count nodes to the list's pool and threads them onto the
+ * freelist.
+ */
+static bool pool_grow(list_t *list, size_t count) {
+  list_pool_t *pool = list->pool;
+  slab_t *slab = malloc(sizeof(slab_t) + count * pool->node_size);
+  if (!slab) {
+    return false;
+  }
+  STATS_ADD(list, allocs, 1);
+  slab->next = pool->slabs;
+  slab->count = count;
+  if (!pool->slabs) {
+    pool->last_slab = slab;
+  }
+  pool->slabs = slab;
+
+  /*
+   * Thread every node of the new slab onto the freelist, back to front, so
+   * that consecutive allocations come out in address order.
+   */
+  for (size_t i = count; i > 0; i--) {
+    node_t *node = (node_t *)((unsigned char *)slab->nodes + (i - 1) * pool->node_size);
+    node->link = pool->free;
+    pool->free = node;
+  }
+  pool->available += count;
+
+  return true;
+}
+
+/**
+ * Drops a reference to the pool. When no lists are left using it, every
+ * slab owned by the pool is released along with the pool itself, and a stub
+ * drops its reference to the pool it was merged into.
+ */
+static void pool_release(list_pool_t *pool) {
+  while (pool && --pool->refs == 0) {
+    slab_t *slab = pool->slabs;
+    while (slab) {
+      slab_t *next = slab->next;
+      free(slab);
+      slab = next;
+    }
+
+    list_pool_t *merged = pool->merged;
+    free(pool);
+    pool = merged;
+  }
+}
+
+/**
+ * Gets the pool a list allocates from (or nullptr), first moving the list
+ * off any stub left behind by pool_merge.
+ */
+static list_pool_t *pool_of(list_t *list) {
+  while (list->pool && list->pool->merged) {
+    list_pool_t *stub = list->pool;
+    list->pool = stub->merged;
+    list->pool->refs += 1;
+    pool_release(stub);
+  }
+
+  return list->pool;
+}
+
+/**
+ * Hands every slab and free node of pool over to into, leaving pool as a
+ * stub that forwards to it. The slab chains are joined in constant time;
+ * joining the freelists walks the shorter of the two.
+ */
+static void pool_merge(list_pool_t *into, list_pool_t *pool) {
+  if (pool->slabs) {
+    if (into->slabs) {
+      pool->last_slab->next = into->slabs;
+    } else {
+      into->last_slab = pool->last_slab;
+    }
+    into->slabs = pool->slabs;
+  }
+
+  node_t *shorter = pool->free;
+  node_t *longer = into->free;
+  if (into->available < pool->available) {
+    shorter = into->free;
+    longer = pool->free;
+  }
+  if (shorter) {
+    node_t *last = shorter;
+    while (last->link) {
+      last = last->link;
+    }
+    last->link = longer;
+    into->free = shorter;
+  } else {
+    into->free = longer;
+  }
+  into->available += pool->available;
+
+  pool->slabs = nullptr;
+  pool->last_slab = nullptr;
+  pool->free = nullptr;
+  pool->available = 0;
+  pool->merged = into;
+  into->refs += 1;
+}
+
+/**
+ * Cuts the nodes from first to last out from between before and after, then
+ * links them in between into_before and into_after.
+ */
+static void move_range(node_t *before, node_t *first, node_t *last, node_t *after,
+                       node_t *into_before, node_t *into_after) {
+  /* Close the gap left behind. */
+  before->link = calc_new_ptr(before->link, first, after);
+  after->link = calc_new_ptr(after->link, last, before);
+
+  /* Point the ends of the range at their new neighbors. */
+  first->link = calc_new_ptr(first->link, before, into_before);
+  last->link = calc_new_ptr(last->link, after, into_after);
+
+  /* Open a gap for the range. */
+  into_before->link = calc_new_ptr(into_before->link, into_after, first);
+  into_after->link = calc_new_ptr(into_after->link, into_before, last);
+}
+
+/**
+ * Makes sure nodes can be relinked from src into dst, merging their pools if
+ * they have different ones. An empty list without a pool takes on the pool
+ * of the other list. Otherwise, nodes can't move between a list without a
+ * pool and one with a pool, since they would later be freed the wrong way.
+ */
+static bool splice_compatible(list_t *dst, list_t *src) {
+  list_pool_t *dst_pool = pool_of(dst);
+  list_pool_t *src_pool = pool_of(src);
+  if (dst_pool == src_pool) {
+    return true;
+  }
+
+  if (dst_pool && src_pool) {
+    pool_merge(dst_pool, src_pool);
+    pool_of(src);
+    return true;
+  }
+  if (!dst_pool && dst->size == 0) {
+    dst->pool = src_pool;
+    src_pool->refs += 1;
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * Copies a range of values from one list into new nodes in another, for
+ * when the nodes themselves can't be moved. Every node is allocated before
+ * anything is moved, so the move either happens in full or not at all.
+ */
+static int move_values(list_t *dst, size_t idx, list_t *src, size_t from, size_t count) {
+  if (dst->hash && !hash_reserve(dst->hash, count)) {
+    return EXIT_FAILURE;
+  }
+  node_t *nodes = node_alloc_many(dst, count);
+  if (!nodes) {
+    return EXIT_FAILURE;
+  }
+  STATS_ADD(dst, inserts, count);
+
+  node_pair_t into = traverse_to_idx(dst, idx);
+  node_t *before = into.prev;
+  list_cursor_t cursor = list_cursor_at(src, from);
+  for (size_t i = 0; i < count; i++) {
+    node_t *node = nodes;
+    nodes = node->link;
+
+    store_value(dst, node, list_cursor_get(cursor));
+    attach_node(dst, node, before, into.curr, UNKNOWN_IDX);
+    before = node;
+    list_cursor_delete(&cursor);
+  }
+
+  return EXIT_SUCCESS;
+}
+
+/**
+ * Turns the list into a plain singly linked chain, with each node's link
+ * pointing straight at the next node (and the last one at nullptr). The
+ * first node of the chain is returned. The list can't be used again until
+ * rethread(list_t *, node_t *) is called.
+ */
+static node_t *unthread(list_t *list) {
+  node_t *prev = list->head;
+  node_t *curr = list_next(list->head, nullptr);
+  node_t *first = curr == list->tail ? nullptr : curr;
+
+  while (curr != list->tail) {
+    node_t *next = list_next(curr, prev);
+    curr->link = next == list->tail ? nullptr : next;
+    prev = curr;
+    curr = next;
+  }
+
+  return first;
+}
+
+/**
+ * Rebuilds the XOR links of the list from a singly linked chain of all of
+ * its nodes.
+ */
+static void rethread(list_t *list, node_t *chain) {
+  node_t *prev = list->head;
+  list->head->link = calc_new_ptr(nullptr, nullptr, chain ? chain : list->tail);
+
+  while (chain) {
+    node_t *next = chain->link;
+    chain->link = calc_new_ptr(prev, nullptr, next ? next : list->tail);
+    prev = chain;
+    chain = next;
+  }
+
+  list->tail->link = calc_new_ptr(prev, nullptr, nullptr);
+  list_changed(list);
+  hash_refresh(list);
+}
+
+/**
+ * Merges two sorted singly linked chains into one. On ties, nodes from the
+ * first chain come first.
+ */
+static node_t *merge_runs(list_t *list, node_t *a, node_t *b, element_comparator compare) {
+  node_t *merged = nullptr;
+  node_t **tail = &merged;
+
+  while (a && b) {
+    if (compare(node_value(list, b), node_value(list, a)) < 0) {
+      *tail = b;
+      b = b->link;
+    } else {
+      *tail = a;
+      a = a->link;
+    }
+    tail = &(*tail)->link;
+  }
+
+  *tail = a ? a : b;
+  return merged;
+}
+
+/**
+ * Called after the nodes of the list have been rearranged in some way other
+ * than adding or removing a single node.
+ */
+static void list_changed(list_t *list) {
+  if (list->anchors) {
+    list->anchors->stale = true;
+  }
+}
+
+/**
+ * Removes the nodes for which the predicate returns match, in a single walk
+ * that keeps track of the node before the current one.
+ */
+static size_t remove_matching(list_t *list, element_predicate predicate, void *ctx,
+                              element_destructor destroy, bool match) {
+  /* Shifting the anchors after every removal would make this quadratic. */
+  list_changed(list);
+
+  STATS_ADD(list, searches, 1);
+  STATS_WALK(list, list->size);
+
+  size_t removed = 0;
+  node_t *prev = list->head;
+  node_t *curr = list_next(list->head, nullptr);
+  while (curr != list->tail) {
+    node_t *next = list_next(curr, prev);
+    list_val_t value = node_value(list, curr);
+    if (predicate(value, ctx) == match) {
+      if (destroy) {
+        destroy(value);
+      }
+      remove_at_node(list, prev, curr, UNKNOWN_IDX);
+      removed++;
+    } else {
+      prev = curr;
+    }
+    curr = next;
+  }
+
+  compact_if_churned(list);
+  return removed;
+}
+
+/**
+ * Compacts the list if automatic compaction is on and enough nodes have been
+ * removed since the last time. Only lists that already have a pool are
+ * compacted, so this never changes how nodes are allocated. A failed
+ * compaction is only retried after another round of removals.
+ */
+static void compact_if_churned(list_t *list) {
+  if (list->compact_after && list->pool && list->churn >= list->compact_after &&
+      list_compact(list)) {
+    list->churn = 0;
+  }
+}
+
+/**
+ * Starts the reclaimer thread, leaving it stopped if that fails so that
+ * list_destroy_async falls back to tearing lists down itself.
+ */
+static void reclaimer_start(void) {
+  pthread_t thread;
+  if (pthread_create(&thread, nullptr, reclaimer_run, nullptr) == 0) {
+    pthread_detach(thread);
+    reclaimer.running = true;
+  }
+}
+
+/**
+ * The body of the reclaimer thread: tears down queued lists forever.
+ */
+static void *reclaimer_run(void *arg) {
+  (void)arg;
+
+  pthread_mutex_lock(&reclaimer.lock);
+  for (;;) {
+    while (!reclaimer.first) {
+      pthread_cond_wait(&reclaimer.work, &reclaimer.lock);
+    }
+    teardown_t *teardown = reclaimer.first;
+    reclaimer.first = teardown->next;
+    if (!reclaimer.first) {
+      reclaimer.last = nullptr;
+    }
+    pthread_mutex_unlock(&reclaimer.lock);
+
+    list_fini(&teardown->list, teardown->destroy);
+    free(teardown);
+
+    pthread_mutex_lock(&reclaimer.lock);
+    reclaimer.pending -= 1;
+    pthread_cond_broadcast(&reclaimer.done);
+  }
+
+  return nullptr;
+}
+
+/**
+ * Makes room for at least the given number of anchors.
+ */
+static bool anchors_reserve(list_anchors_t *anchors, size_t count) {
+  if (count <= anchors->capacity) {
+    return true;
+  }
+
+  size_t capacity = anchors->capacity ? anchors->capacity : 16;
+  while (capacity < count) {
+    capacity *= 2;
+  }
+
+  node_pair_t *pairs = realloc(anchors->pairs, capacity * sizeof(node_pair_t));
+  if (!pairs) {
+    return false;
+  }
+
+  anchors->pairs = pairs;
+  anchors->capacity = capacity;
+  return true;
+}
+
+/**
+ * Rebuilds the anchors with a single walk of the list.
+ */
+static bool anchors_rebuild(list_t *list) {
+  list_anchors_t *anchors = list->anchors;
+  size_t count = list->size > 0 ? (list->size - 1) / anchors->spacing : 0;
+
+  if (!anchors_reserve(anchors, count)) {
+    return false;
+  }
+
+  node_pair_t nodes = {.prev = list->head, .curr = list_next(list->head, nullptr)};
+  for (size_t j = 0; j < count; j++) {
+    nodes = walk_forward(nodes, anchors->spacing);
+    anchors->pairs[j] = nodes;
+  }
+
+  anchors->count = count;
+  anchors->stale = false;
+  return true;
+}
+
+/**
+ * Updates the anchors after a node was linked in at an index, right after
+ * the before node.
+ */
+static void anchors_after_insert(list_t *list, size_t idx, node_t *before, node_t *new_node) {
+  list_anchors_t *anchors = list->anchors;
+  if (!anchors || anchors->stale) {
+    return;
+  }
+  if (idx == UNKNOWN_IDX) {
+    anchors->stale = true;
+    return;
+  }
+
+  /* Skip the anchors before idx. */
+  size_t first = idx > 0 ? (idx - 1) / anchors->spacing : 0;
+  for (size_t j = first; j < anchors->count; j++) {
+    node_pair_t *pair = &anchors->pairs[j];
+    if ((j + 1) * anchors->spacing == idx) {
+      /* The anchor now lands on the new node. */
+      pair->prev = before;
+      pair->curr = new_node;
+      continue;
+    }
+
+    /* Every later anchor lands one node earlier than it did. */
+    node_t *prev = list_prev(pair->prev, pair->curr);
+    pair->curr = pair->prev;
+    pair->prev = prev;
+  }
+
+  /* The last node may have just reached the next anchor index. */
+  if ((anchors->count + 1) * anchors->spacing == list->size - 1) {
+    if (!anchors_reserve(anchors, anchors->count + 1)) {
+      anchors->stale = true;
+      return;
+    }
+    node_t *last = list_prev(list->tail, nullptr);
+    node_pair_t pair = {.prev = list_prev(last, list->tail), .curr = last};
+    anchors->pairs[anchors->count++] = pair;
+  }
+}
+
+/**
+ * Updates the anchors after the node at an index was unlinked from between
+ * the prev and next nodes.
+ */
+static void anchors_after_remove(list_t *list, size_t idx, node_t *prev, node_t *next) {
+  list_anchors_t *anchors = list->anchors;
+  if (!anchors || anchors->stale) {
+    return;
+  }
+  if (idx == UNKNOWN_IDX) {
+    anchors->stale = true;
+    return;
+  }
+
+  /* Skip the anchors before idx. */
+  size_t first = idx > 0 ? (idx - 1) / anchors->spacing : 0;
+  for (size_t j = first; j < anchors->count; j++) {
+    node_pair_t *pair = &anchors->pairs[j];
+    size_t anchor_idx = (j + 1) * anchors->spacing;
+
+    if (anchor_idx == idx) {
+      /* The anchor now lands on the node after the removed one. */
+      pair->curr = next;
+    } else if (anchor_idx == idx + 1) {
+      /* The anchor was just after the removed node, which can't be used. */
+      pair->prev = next;
+      pair->curr = list_next(next, prev);
+    } else {
+      /* Every later anchor lands one node later than it did. */
+      node_t *curr = list_next(pair->curr, pair->prev);
+      pair->prev = pair->curr;
+      pair->curr = curr;
+    }
+  }
+
+  /* The last anchor may now be past the end of the list. */
+  if (anchors->count > 0 && anchors->count * anchors->spacing >= list->size) {
+    anchors->count -= 1;
+  }
+}
+
+/**
+ * Changes the value held by a node, returning the old value (or, for inline
+ * values, where the new one is stored).
+ */
+static list_val_t replace_value(list_t *list, node_t *node, list_val_t value) {
+  if (list->elem_size) {
+    store_value(list, node, value);
+    return node_data(node);
+  }
+
+  list_val_t prior_value = node->value;
+  hash_entry_t *entry = hash_entry_of(list, node);
+
+  /* The node's entry has to move to the slot for the new value. */
+  if (entry) {
+    node_t *neighbor = entry->neighbor;
+    hash_erase(list->hash, entry);
+    hash_put(list->hash, value, node, neighbor);
+  }
+  node->value = value;
+
+  return prior_value;
+}
+
+/**
+ * The slot a value's entry would be in if nothing collided with it.
+ */
+static size_t hash_slot(list_hash_t *hash, list_val_t value) {
+  uint64_t key = (uint64_t)UNSAFE_PTR_TO_INT(value) * UINT64_C(0x9E3779B97F4A7C15);
+  return (size_t)(key ^ (key >> 32)) & (hash->capacity - 1);
+}
+
+/**
+ * Finds an entry for a value, or nullptr if no node holds it.
+ */
+static hash_entry_t *hash_lookup(list_hash_t *hash, list_val_t value) {
+  if (hash->count == 0) {
+    return nullptr;
+  }
+
+  size_t mask = hash->capacity - 1;
+  for (size_t i = hash_slot(hash, value); hash->entries[i].node; i = (i + 1) & mask) {
+    if (hash->entries[i].value == value) {
+      return &hash->entries[i];
+    }
+  }
+
+  return nullptr;
+}
+
+/**
+ * Finds the entry for a particular node, or nullptr if the list has no hash
+ * index or the node is the head or tail.
+ */
+static hash_entry_t *hash_entry_of(list_t *list, node_t *node) {
+  list_hash_t *hash = list->hash;
+  if (!hash || is_sentinel(list, node)) {
+    return nullptr;
+  }
+
+  size_t mask = hash->capacity - 1;
+  for (size_t i = hash_slot(hash, node->value); hash->entries[i].node; i = (i + 1) & mask) {
+    if (hash->entries[i].node == node) {
+      return &hash->entries[i];
+    }
+  }
+
+  return nullptr;
+}
+
+/**
+ * Adds an entry to the hash index, which must already have room for it.
+ */
+static void hash_put(list_hash_t *hash, list_val_t value, node_t *node, node_t *neighbor) {
+  size_t mask = hash->capacity - 1;
+  size_t i = hash_slot(hash, value);
+  while (hash->entries[i].node) {
+    i = (i + 1) & mask;
+  }
+
+  hash_entry_t entry = {.value = value, .node = node, .neighbor = neighbor};
+  hash->entries[i] = entry;
+  hash->count += 1;
+}
+
+/**
+ * Removes an entry from the hash index, shifting later entries of the same
+ * probe sequence back into the gap so that lookups never stop short.
+ */
+static void hash_erase(list_hash_t *hash, hash_entry_t *entry) {
+  size_t mask = hash->capacity - 1;
+  size_t hole = entry - hash->entries;
+
+  for (size_t i = (hole + 1) & mask; hash->entries[i].node; i = (i + 1) & mask) {
+    /* An entry can fill the hole if the hole is no further from its slot. */
+    size_t slot = hash_slot(hash, hash->entries[i].value);
+    if (((i - slot) & mask) >= ((i - hole) & mask)) {
+      hash->entries[hole] = hash->entries[i];
+      hole = i;
+    }
+  }
+
+  hash->entries[hole].node = nullptr;
+  hash->count -= 1;
+}
+
+/**
+ * Makes room in the hash index for at least the given number of new entries.
+ */
+static bool hash_reserve(list_hash_t *hash, size_t count) {
+  size_t needed = (hash->count + count) * 2;
+  if (needed <= hash->capacity) {
+    return true;
+  }
+
+  size_t capacity = hash->capacity ? hash->capacity : HASH_MIN_CAPACITY;
+  while (capacity < needed) {
+    capacity *= 2;
+  }
+
+  hash_entry_t *entries = calloc(capacity, sizeof(hash_entry_t));
+  if (!entries) {
+    return false;
+  }
+
+  hash_entry_t *old_entries = hash->entries;
+  size_t old_capacity = hash->capacity;
+  hash->entries = entries;
+  hash->capacity = capacity;
+  hash->count = 0;
+
+  for (size_t i = 0; i < old_capacity; i++) {
+    if (old_entries[i].node) {
+      hash_put(hash, old_entries[i].value, old_entries[i].node, old_entries[i].neighbor);
+    }
+  }
+
+  free(old_entries);
+  return true;
+}
+
+/**
+ * Updates the neighbor recorded for a node after the neighbor it had on one
+ * side was replaced.
+ */
+static void hash_retarget(list_t *list, node_t *node, node_t *from, node_t *to) {
+  hash_entry_t *entry = hash_entry_of(list, node);
+  if (entry && entry->neighbor == from) {
+    entry->neighbor = to;
+  }
+}
+
+/**
+ * Updates the hash indexes of both lists after move_range moved count nodes
+ * from src to dst. The arguments are the same as for move_range.
+ */
+static void hash_after_move(list_t *dst, list_t *src, node_t *before, node_t *first,
+                            node_t *last, node_t *after, node_t *into_before,
+                            node_t *into_after, size_t count) {
+  node_t *prev = into_before;
+  node_t *curr = first;
+
+  for (size_t i = 0; i < count; i++) {
+    if (src->hash) {
+      hash_erase(src->hash, hash_entry_of(src, curr));
+    }
+    if (dst->hash) {
+      hash_put(dst->hash, curr->value, curr, prev);
+    }
+    node_t *next = list_next(curr, prev);
+    prev = curr;
+    curr = next;
+  }
+
+  /* The nodes around both gaps have new neighbors. */
+  hash_retarget(src, before, first, after);
+  hash_retarget(src, after, last, before);
+  hash_retarget(dst, into_before, into_after, first);
+  hash_retarget(dst, into_after, into_before, last);
+}
+
+/**
+ * Records a fresh neighbor for every node in the hash index after the nodes
+ * of the list were rearranged.
+ */
+static void hash_refresh(list_t *list) {
+  if (!list->hash) {
+    return;
+  }
+
+  node_t *prev = list->head;
+  node_t *curr = list_next(list->head, nullptr);
+  while (curr != list->tail) {
+    hash_entry_of(list, curr)->neighbor = prev;
+    node_t *next = list_next(curr, prev);
+    prev = curr;
+    curr = next;
+  }
+}
+
+#ifdef XORLIST_STATS
+/**
+ * Records a walk of a number of steps along the list.
+ */
+static void stats_walk(list_t *list, size_t steps) {
+  struct list_stats *stats = list->stats;
+
+  stats->steps += steps;
+  if (steps > stats->max_steps) {
+    stats->max_steps = steps;
+  }
+  if (steps > XORLIST_STATS_LONG_WALK) {
+    stats->long_walks += 1;
+  }
 }
+#endif
@@ -0,0 +1,154 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+
+#include "alist.h"
+
+static int destroy_count = 0;
+static alist_val_t destroy_sum = 0;
+static void destroy_counter(alist_val_t value) {
+    destroy_count += 1;
+    destroy_sum += value;
+}
+
+START_TEST(ALIST_CREATE)
+{
+    alist_t *list = alist_create();
+    ck_assert(list);
+    ck_assert(alist_is_empty(*list));
+
+    alist_val_t value = 7;
+    ck_assert(alist_peek(*list, &value) == EXIT_FAILURE);
+    ck_assert(value == 7);
+    ck_assert(alist_pop(list, nullptr) == EXIT_FAILURE);
+    ck_assert(alist_find(*list, 0) == -1);
+    alist_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(ALIST_DESTROY)
+{
+    alist_t *list = alist_create();
+    for (alist_val_t i = 1; i <= 10; i++) {
+        ck_assert(alist_append(list, i) == EXIT_SUCCESS);
+    }
+
+    destroy_count = 0;
+    destroy_sum = 0;
+    alist_destroy(list, destroy_counter);
+    ck_assert(destroy_count == 10);
+    ck_assert(destroy_sum == 55);
+}
+END_TEST
+
+START_TEST(ALIST_INSERT_DELETE)
+{
+    alist_t *list = alist_create();
+
+    /* Enough elements to make the arena grow several times. */
+    for (alist_val_t i = 0; i < 1000; i++) {
+        ck_assert(alist_append(list, i * 2) == EXIT_SUCCESS);
+    }
+    for (alist_val_t i = 0; i < 1000; i++) {
+        ck_assert(alist_insert(list, i * 2 + 1, i * 2 + 1) == EXIT_SUCCESS);
+    }
+    ck_assert(alist_insert(list, 2001, 0) == EXIT_FAILURE);
+    ck_assert(alist_size(*list) == 2000);
+
+    for (size_t i = 0; i < 2000; i++) {
+        alist_val_t value;
+        ck_assert(alist_get(*list, i, &value) == EXIT_SUCCESS);
+        ck_assert(value == i);
+    }
+
+    /* Delete every other element, from both halves of the list. */
+    size_t arena = list->used;
+    for (size_t i = 0; i < 1000; i++) {
+        alist_val_t value;
+        ck_assert(alist_delete(list, i, &value) == EXIT_SUCCESS);
+        ck_assert(value == i * 2);
+    }
+    ck_assert(alist_delete(list, 1000, nullptr) == EXIT_FAILURE);
+    ck_assert(alist_find(*list, 999) == 499);
+    ck_assert(!alist_contains(*list, 998));
+
+    /* Removed nodes are reused before the arena grows. */
+    for (alist_val_t i = 0; i < 1000; i++) {
+        ck_assert(alist_prepend(list, i) == EXIT_SUCCESS);
+    }
+    ck_assert(list->used == arena);
+
+    alist_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(ALIST_QUEUE_STACK)
+{
+    alist_t *list = alist_create();
+    ck_assert(alist_reserve(list, 100) == EXIT_SUCCESS);
+    ck_assert(list->capacity >= 103);
+
+    for (alist_val_t i = 0; i < 100; i++) {
+        ck_assert(alist_enqueue(list, i) == EXIT_SUCCESS);
+    }
+    alist_val_t value;
+    for (alist_val_t i = 0; i < 100; i++) {
+        ck_assert(alist_dequeue(list, &value) == EXIT_SUCCESS);
+        ck_assert(value == i);
+    }
+
+    for (alist_val_t i = 0; i < 100; i++) {
+        ck_assert(alist_push(list, i) == EXIT_SUCCESS);
+    }
+    ck_assert(alist_peek(*list, &value) == EXIT_SUCCESS && value == 99);
+    for (alist_val_t i = 100; i > 0; i--) {
+        ck_assert(alist_pop(list, &value) == EXIT_SUCCESS);
+        ck_assert(value == i - 1);
+    }
+    ck_assert(alist_is_empty(*list));
+
+    alist_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(ALIST_SET_REMOVE_REVERSE)
+{
+    alist_t *list = alist_create();
+    for (alist_val_t i = 0; i < 20; i++) {
+        ck_assert(alist_append(list, i) == EXIT_SUCCESS);
+    }
+
+    ck_assert(alist_set(list, 5, 500) == EXIT_SUCCESS);
+    ck_assert(alist_set(list, 20, 0) == EXIT_FAILURE);
+    ck_assert(alist_find(*list, 500) == 5);
+    ck_assert(alist_remove(list, 500) == 5);
+    ck_assert(alist_remove(list, 500) == -1);
+    ck_assert(alist_size(*list) == 19);
+
+    alist_reverse(list);
+    alist_val_t value;
+    ck_assert(alist_get(*list, 0, &value) == EXIT_SUCCESS && value == 19);
+    ck_assert(alist_get(*list, 18, &value) == EXIT_SUCCESS && value == 0);
+    ck_assert(alist_find(*list, 4) == 14);
+
+    ck_assert(alist_append(list, 100) == EXIT_SUCCESS);
+    ck_assert(alist_prepend(list, 200) == EXIT_SUCCESS);
+    ck_assert(alist_get(*list, 0, &value) == EXIT_SUCCESS && value == 200);
+    ck_assert(alist_get(*list, 20, &value) == EXIT_SUCCESS && value == 100);
+
+    alist_destroy(list, nullptr);
+}
+END_TEST
+
+void alist_tests (Suite *s) {
+    TCase *tests = tcase_create("alist");
+    tcase_add_test(tests, ALIST_CREATE);
+    tcase_add_test(tests, ALIST_DESTROY);
+    tcase_add_test(tests, ALIST_INSERT_DELETE);
+    tcase_add_test(tests, ALIST_QUEUE_STACK);
+    tcase_add_test(tests, ALIST_SET_REMOVE_REVERSE);
+    suite_add_tcase(s, tests);
+}
@@ -0,0 +1,107 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <check.h>
+
+#include "bqueue.h"
+#include "list.h"
+
+#define PIPELINE_ITEMS 50000
+
+static int destroy_count = 0;
+static void destroy_counter(list_val_t _) {
+    destroy_count += 1;
+}
+
+START_TEST(BQUEUE_BOUNDS)
+{
+    bqueue_t *queue = bqueue_create(3);
+    int values[5];
+    list_val_t out[5];
+
+    ck_assert(bqueue_create(0) == nullptr);
+    ck_assert(queue);
+
+    /* Empty and full queues time out instead of blocking forever. */
+    ck_assert(bqueue_dequeue(queue, 0) == nullptr);
+    ck_assert(bqueue_dequeue_n(queue, out, 5, 10) == 0);
+    for (int i = 0; i < 3; i++) {
+        ck_assert(!bqueue_enqueue(queue, values + i, 0));
+    }
+    ck_assert(bqueue_enqueue(queue, values + 3, 0));
+    ck_assert(bqueue_enqueue(queue, values + 3, 10));
+    ck_assert(bqueue_size(queue) == 3);
+
+    ck_assert(bqueue_dequeue(queue, BQUEUE_FOREVER) == values);
+    ck_assert(!bqueue_enqueue(queue, values + 3, 0));
+    ck_assert(bqueue_dequeue_n(queue, out, 5, BQUEUE_FOREVER) == 3);
+    for (int i = 0; i < 3; i++) {
+        ck_assert(out[i] == values + 1 + i);
+    }
+
+    /* A closed queue can still be drained, but not added to. */
+    ck_assert(!bqueue_enqueue(queue, values + 4, 0));
+    bqueue_close(queue);
+    ck_assert(bqueue_enqueue(queue, values, BQUEUE_FOREVER));
+    ck_assert(bqueue_dequeue(queue, BQUEUE_FOREVER) == values + 4);
+    ck_assert(bqueue_dequeue(queue, BQUEUE_FOREVER) == nullptr);
+
+    bqueue_destroy(queue, nullptr);
+
+    queue = bqueue_create(4);
+    ck_assert(!bqueue_enqueue(queue, values, 0));
+    ck_assert(!bqueue_enqueue(queue, values + 1, 0));
+    destroy_count = 0;
+    bqueue_destroy(queue, destroy_counter);
+    ck_assert(destroy_count == 2);
+    destroy_count = 0;
+}
+END_TEST
+
+static void *produce(void *arg) {
+    bqueue_t *queue = arg;
+    uintptr_t failures = 0;
+
+    /* Values are 1-based so that nullptr never goes in the queue. */
+    for (uintptr_t i = 1; i <= PIPELINE_ITEMS; i++) {
+        failures += bqueue_enqueue(queue, (list_val_t)i, BQUEUE_FOREVER) != EXIT_SUCCESS;
+    }
+    bqueue_close(queue);
+
+    return (void *)failures;
+}
+
+START_TEST(BQUEUE_PIPELINE)
+{
+    bqueue_t *queue = bqueue_create(16);
+    pthread_t producer;
+    void *failures;
+    list_val_t batch[8];
+    uintptr_t expected = 1;
+
+    ck_assert(!pthread_create(&producer, nullptr, produce, queue));
+
+    /* Items come out in order until the producer closes the queue. */
+    size_t count;
+    while ((count = bqueue_dequeue_n(queue, batch, 8, BQUEUE_FOREVER)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            ck_assert((uintptr_t)batch[i] == expected++);
+        }
+    }
+    ck_assert(expected == PIPELINE_ITEMS + 1);
+
+    pthread_join(producer, &failures);
+    ck_assert(failures == nullptr);
+    bqueue_destroy(queue, nullptr);
+}
+END_TEST
+
+void bqueue_tests (Suite *s) {
+    TCase *tests = tcase_create("bqueue");
+    tcase_set_timeout(tests, 30);
+    tcase_add_test(tests, BQUEUE_BOUNDS);
+    tcase_add_test(tests, BQUEUE_PIPELINE);
+    suite_add_tcase(s, tests);
+}
@@ -0,0 +1,157 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <check.h>
+
+#include "cqueue.h"
+#include "list.h"
+
+#define PRODUCERS 4
+#define CONSUMERS 4
+#define ITEMS_PER_PRODUCER 20000
+
+static int destroy_count = 0;
+static void destroy_counter(list_val_t _) {
+    destroy_count += 1;
+}
+
+START_TEST(CQUEUE_FIFO)
+{
+    cqueue_t *queue = cqueue_create();
+    int values[10];
+    list_val_t out[10];
+
+    ck_assert(queue);
+    ck_assert(cqueue_is_empty(queue));
+    ck_assert(cqueue_dequeue(queue) == nullptr);
+    ck_assert(cqueue_dequeue_n(queue, out, 10) == 0);
+
+    for (int i = 0; i < 4; i++) {
+        ck_assert(!cqueue_enqueue(queue, values + i));
+    }
+    list_val_t batch[6] = {values + 4, values + 5, values + 6, values + 7, values + 8, values + 9};
+    ck_assert(!cqueue_enqueue_n(queue, batch, 6));
+    ck_assert(cqueue_size(queue) == 10);
+
+    ck_assert(cqueue_dequeue(queue) == values);
+    ck_assert(cqueue_dequeue_n(queue, out, 3) == 3);
+    for (int i = 0; i < 3; i++) {
+        ck_assert(out[i] == values + 1 + i);
+    }
+
+    /* Asking for more than there is drains the queue. */
+    ck_assert(cqueue_dequeue_n(queue, out, 10) == 6);
+    for (int i = 0; i < 6; i++) {
+        ck_assert(out[i] == values + 4 + i);
+    }
+    ck_assert(cqueue_is_empty(queue));
+
+    ck_assert(!cqueue_enqueue_n(queue, batch, 6));
+    destroy_count = 0;
+    cqueue_destroy(queue, destroy_counter);
+    ck_assert(destroy_count == 6);
+    destroy_count = 0;
+}
+END_TEST
+
+typedef struct {
+    cqueue_t *queue;
+    size_t id;
+    atomic_size_t *remaining;
+    unsigned char *seen;
+    bool in_order;
+} worker_t;
+
+static void *produce(void *arg) {
+    worker_t *worker = arg;
+    list_val_t batch[8];
+
+    /* Values are 1-based so that nullptr never goes in the queue. */
+    for (size_t i = 0; i < ITEMS_PER_PRODUCER; i += 8) {
+        for (size_t j = 0; j < 8; j++) {
+            batch[j] = (list_val_t)(uintptr_t)(worker->id * ITEMS_PER_PRODUCER + i + j + 1);
+        }
+        if (i % 16 == 0) {
+            cqueue_enqueue_n(worker->queue, batch, 8);
+        } else {
+            for (size_t j = 0; j < 8; j++) {
+                cqueue_enqueue(worker->queue, batch[j]);
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+static void *consume(void *arg) {
+    worker_t *worker = arg;
+    uintptr_t last[PRODUCERS] = {0};
+    list_val_t batch[5];
+
+    while (atomic_load(worker->remaining) > 0) {
+        size_t count = cqueue_dequeue_n(worker->queue, batch, 1 + worker->id % 5);
+        atomic_fetch_sub(worker->remaining, count);
+
+        for (size_t i = 0; i < count; i++) {
+            uintptr_t value = (uintptr_t)batch[i];
+            size_t producer = (value - 1) / ITEMS_PER_PRODUCER;
+            worker->seen[value - 1] += 1;
+
+            /* Each producer's items come out in the order they went in. */
+            if (value <= last[producer]) {
+                worker->in_order = false;
+            }
+            last[producer] = value;
+        }
+    }
+
+    return nullptr;
+}
+
+START_TEST(CQUEUE_THREADS)
+{
+    cqueue_t *queue = cqueue_create();
+    static unsigned char seen[PRODUCERS * ITEMS_PER_PRODUCER];
+    atomic_size_t remaining = PRODUCERS * ITEMS_PER_PRODUCER;
+    pthread_t threads[PRODUCERS + CONSUMERS];
+    worker_t workers[PRODUCERS + CONSUMERS];
+
+    memset(seen, 0, sizeof(seen));
+    for (size_t i = 0; i < PRODUCERS + CONSUMERS; i++) {
+        bool producer = i < PRODUCERS;
+        workers[i] = (worker_t){
+            .queue = queue,
+            .id = producer ? i : i - PRODUCERS,
+            .remaining = &remaining,
+            .seen = seen,
+            .in_order = true,
+        };
+        ck_assert(!pthread_create(&threads[i], nullptr, producer ? produce : consume, &workers[i]));
+    }
+    for (size_t i = 0; i < PRODUCERS + CONSUMERS; i++) {
+        pthread_join(threads[i], nullptr);
+    }
+
+    for (size_t i = 0; i < PRODUCERS * ITEMS_PER_PRODUCER; i++) {
+        ck_assert(seen[i] == 1);
+    }
+    for (size_t i = PRODUCERS; i < PRODUCERS + CONSUMERS; i++) {
+        ck_assert(workers[i].in_order);
+    }
+    ck_assert(cqueue_is_empty(queue));
+
+    cqueue_destroy(queue, nullptr);
+}
+END_TEST
+
+void cqueue_tests (Suite *s) {
+    TCase *tests = tcase_create("cqueue");
+    tcase_set_timeout(tests, 30);
+    tcase_add_test(tests, CQUEUE_FIFO);
+    tcase_add_test(tests, CQUEUE_THREADS);
+    suite_add_tcase(s, tests);
+}
@@ -0,0 +1,102 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <check.h>
+
+#include "xorlist_gen.h"
+
+typedef struct point {
+    int x;
+    int y;
+} point_t;
+
+static bool point_eq(point_t a, point_t b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+XORLIST_DEFINE(ints, int)
+XORLIST_DEFINE_EQ(points, point_t, point_eq)
+
+static int destroy_count = 0;
+static void destroy_point(point_t *_) {
+    destroy_count += 1;
+}
+
+START_TEST(GEN_INTS)
+{
+    ints_t list;
+    int out;
+
+    ints_init(&list);
+    ck_assert(ints_is_empty(&list));
+    ck_assert(ints_get(&list, 0) == nullptr);
+    ck_assert(ints_pop(&list, &out));
+
+    for (int i = 0; i < 100; i++) {
+        ck_assert(!ints_append(&list, i));
+    }
+    ck_assert(!ints_push(&list, -1));
+    ck_assert(!ints_insert(&list, 50, 1000));
+    ck_assert(ints_insert(&list, 103, 0));
+    ck_assert(ints_size(&list) == 102);
+
+    ck_assert(*ints_get(&list, 0) == -1);
+    ck_assert(*ints_get(&list, 50) == 1000);
+    ck_assert(*ints_get(&list, 101) == 99);
+    ck_assert(ints_find(&list, 1000) == 50);
+    ck_assert(ints_find(&list, 5000) == -1);
+    ck_assert(ints_remove(&list, 1000) == 50);
+    ck_assert(!ints_contains(&list, 1000));
+    ck_assert(!ints_set(&list, 1, 7));
+    ck_assert(*ints_get(&list, 1) == 7);
+    ck_assert(!ints_set(&list, 1, 0));
+
+    ck_assert(!ints_dequeue(&list, &out));
+    ck_assert(out == -1);
+    ck_assert(!ints_delete(&list, 99, &out));
+    ck_assert(out == 99);
+
+    int sum = 0;
+    XORLIST_FOREACH(ints, &list, it) {
+        sum += *ints_ref(it);
+    }
+    ck_assert(sum == 98 * 99 / 2);
+
+    ints_reverse(&list);
+    ck_assert(*ints_get(&list, 0) == 98);
+    ck_assert(*ints_get(&list, 98) == 0);
+    ck_assert(!ints_enqueue(&list, -5));
+    ck_assert(*ints_get(&list, 99) == -5);
+
+    ints_fini(&list, nullptr);
+    ck_assert(ints_is_empty(&list));
+}
+END_TEST
+
+START_TEST(GEN_STRUCTS)
+{
+    points_t list;
+    points_init(&list);
+
+    for (int i = 0; i < 10; i++) {
+        ck_assert(!points_prepend(&list, (point_t){ .x = i, .y = -i }));
+    }
+    ck_assert(points_find(&list, (point_t){ .x = 3, .y = -3 }) == 6);
+    ck_assert(!points_contains(&list, (point_t){ .x = 3, .y = 3 }));
+    ck_assert(points_remove(&list, (point_t){ .x = 9, .y = -9 }) == 0);
+    ck_assert(points_get(&list, 0)->x == 8);
+
+    destroy_count = 0;
+    points_fini(&list, destroy_point);
+    ck_assert(destroy_count == 9);
+    destroy_count = 0;
+}
+END_TEST
+
+void gen_tests (Suite *s) {
+    TCase *tests = tcase_create("gen");
+    tcase_add_test(tests, GEN_INTS);
+    tcase_add_test(tests, GEN_STRUCTS);
+    suite_add_tcase(s, tests);
+}
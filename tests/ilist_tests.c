@@ -0,0 +1,103 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <check.h>
+
+#include "ilist.h"
+
+typedef struct task {
+    int id;
+    xor_link_t ready;
+    xor_link_t all;
+} task_t;
+
+static int release_count = 0;
+static void release_counter(xor_link_t *_) {
+    release_count += 1;
+}
+
+START_TEST(ILIST_BASICS)
+{
+    ilist_t list;
+    task_t tasks[10];
+
+    ilist_init(&list);
+    ck_assert(ilist_is_empty(list));
+    ck_assert(ilist_pop(&list) == nullptr);
+    ck_assert(ilist_insert(&list, 1, &tasks[0].ready));
+
+    for (int i = 0; i < 10; i++) {
+        tasks[i].id = i;
+        ck_assert(!ilist_append(&list, &tasks[i].ready));
+    }
+    ck_assert(ilist_size(list) == 10);
+
+    /* The elements come back as themselves. */
+    for (int i = 0; i < 10; i++) {
+        task_t *task = ilist_entry(ilist_get(list, i), task_t, ready);
+        ck_assert(task == &tasks[i]);
+    }
+
+    ck_assert(ilist_find(list, &tasks[7].ready) == 7);
+    ck_assert(ilist_remove(&list, &tasks[7].ready) == 7);
+    ck_assert(!ilist_contains(list, &tasks[7].ready));
+    ck_assert(ilist_remove(&list, &tasks[7].ready) == -1);
+    ck_assert(!ilist_insert(&list, 3, &tasks[7].ready));
+    ck_assert(ilist_find(list, &tasks[7].ready) == 3);
+
+    ck_assert(ilist_delete(&list, 3) == &tasks[7].ready);
+    ck_assert(!ilist_push(&list, &tasks[7].ready));
+    ck_assert(ilist_entry(ilist_peek(list), task_t, ready)->id == 7);
+    ck_assert(ilist_dequeue(&list) == &tasks[7].ready);
+
+    ilist_reverse(&list);
+    ck_assert(ilist_entry(ilist_peek(list), task_t, ready)->id == 9);
+    ck_assert(!ilist_enqueue(&list, &tasks[7].ready));
+    ck_assert(ilist_entry(ilist_get(list, 9), task_t, ready)->id == 7);
+    ck_assert(ilist_entry(ilist_get(list, 8), task_t, ready)->id == 0);
+
+    release_count = 0;
+    ilist_clear(&list, release_counter);
+    ck_assert(release_count == 10);
+    ck_assert(ilist_is_empty(list));
+    release_count = 0;
+}
+END_TEST
+
+START_TEST(ILIST_MULTIPLE)
+{
+    ilist_t ready;
+    ilist_t all;
+    task_t tasks[6];
+
+    ilist_init(&ready);
+    ilist_init(&all);
+
+    /* Each link puts an element in a different list. */
+    for (int i = 0; i < 6; i++) {
+        tasks[i].id = i;
+        ck_assert(!ilist_append(&all, &tasks[i].all));
+        if (i % 2 == 0) {
+            ck_assert(!ilist_prepend(&ready, &tasks[i].ready));
+        }
+    }
+
+    ck_assert(ilist_size(all) == 6);
+    ck_assert(ilist_size(ready) == 3);
+    ck_assert(ilist_entry(ilist_peek(ready), task_t, ready) == &tasks[4]);
+    ck_assert(ilist_remove(&all, &tasks[4].all) == 4);
+    ck_assert(ilist_entry(ilist_get(all, 4), task_t, all) == &tasks[5]);
+    ck_assert(ilist_entry(ilist_pop(&ready), task_t, ready) == &tasks[4]);
+
+    ilist_clear(&ready, nullptr);
+    ilist_clear(&all, nullptr);
+}
+END_TEST
+
+void ilist_tests (Suite *s) {
+    TCase *tests = tcase_create("ilist");
+    tcase_add_test(tests, ILIST_BASICS);
+    tcase_add_test(tests, ILIST_MULTIPLE);
+    suite_add_tcase(s, tests);
+}
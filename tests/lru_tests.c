@@ -0,0 +1,138 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <check.h>
+
+#include "list.h"
+#include "lru.h"
+
+typedef struct data {
+    int val;
+} data_t;
+
+static int evict_count = 0;
+static list_val_t last_evicted = nullptr;
+static void evict_counter(list_val_t value) {
+    evict_count += 1;
+    last_evicted = value;
+}
+
+START_TEST(LRU_CREATE)
+{
+    ck_assert(lru_create(0, nullptr) == nullptr);
+
+    lru_t *cache = lru_create(4, nullptr);
+    ck_assert(cache);
+    ck_assert(lru_size(*cache) == 0);
+    ck_assert(lru_oldest(*cache) == nullptr);
+    ck_assert(!lru_get(cache, nullptr));
+    lru_destroy(cache, nullptr);
+}
+END_TEST
+
+START_TEST(LRU_EVICT)
+{
+    lru_t *cache = lru_create(3, evict_counter);
+    data_t values[5];
+
+    for (int i = 0; i < 5; i++) {
+        values[i] = (data_t){ .val = i };
+    }
+
+    evict_count = 0;
+    for (int i = 0; i < 3; i++) {
+        ck_assert(!lru_put(cache, values + i));
+    }
+    ck_assert(lru_size(*cache) == 3);
+    ck_assert(lru_oldest(*cache) == values);
+    ck_assert(evict_count == 0);
+
+    /* Using the oldest item saves it from eviction. */
+    ck_assert(lru_get(cache, values));
+    ck_assert(lru_oldest(*cache) == values + 1);
+    ck_assert(!lru_put(cache, values + 3));
+    ck_assert(evict_count == 1);
+    ck_assert(last_evicted == values + 1);
+    ck_assert(!lru_contains(*cache, values + 1));
+
+    /* Putting an item that is already there only marks it as used. */
+    ck_assert(!lru_put(cache, values + 2));
+    ck_assert(lru_size(*cache) == 3);
+    ck_assert(lru_oldest(*cache) == values);
+    ck_assert(!lru_put(cache, values + 4));
+    ck_assert(evict_count == 2);
+    ck_assert(last_evicted == values);
+
+    /* Checking for an item doesn't change the order. */
+    ck_assert(lru_contains(*cache, values + 3));
+    ck_assert(lru_oldest(*cache) == values + 3);
+
+    /* Removed items aren't evicted. */
+    ck_assert(lru_remove(cache, values + 3));
+    ck_assert(!lru_remove(cache, values + 3));
+    ck_assert(evict_count == 2);
+    ck_assert(lru_size(*cache) == 2);
+    ck_assert(lru_oldest(*cache) == values + 2);
+
+    evict_count = 0;
+    lru_destroy(cache, evict_counter);
+    ck_assert(evict_count == 2);
+    evict_count = 0;
+}
+END_TEST
+
+START_TEST(LRU_CHURN)
+{
+    lru_t *cache = lru_create(8, nullptr);
+    data_t values[32];
+    list_val_t order[8];
+    size_t size = 0;
+
+    for (int i = 0; i < 32; i++) {
+        values[i] = (data_t){ .val = i };
+    }
+
+    /* Keep the expected order by hand, most recent first. */
+    for (int round = 0; round < 1000; round++) {
+        list_val_t value = values + (rand() % 32);
+        size_t pos = 0;
+        while (pos < size && order[pos] != value) {
+            pos++;
+        }
+
+        if (rand() % 2) {
+            ck_assert(lru_get(cache, value) == (pos < size));
+            if (pos == size) {
+                continue;
+            }
+        } else {
+            ck_assert(!lru_put(cache, value));
+            if (pos == size && size < 8) {
+                size++;
+            }
+            pos = pos < size ? pos : size - 1;
+        }
+
+        for (size_t i = pos; i > 0; i--) {
+            order[i] = order[i - 1];
+        }
+        order[0] = value;
+
+        ck_assert(lru_size(*cache) == size);
+        for (size_t i = 0; i < size; i++) {
+            ck_assert(list_get(*cache->list, i) == order[i]);
+        }
+    }
+
+    lru_destroy(cache, nullptr);
+}
+END_TEST
+
+void lru_tests (Suite *s) {
+    TCase *tests = tcase_create("lru");
+    tcase_add_test(tests, LRU_CREATE);
+    tcase_add_test(tests, LRU_EVICT);
+    tcase_add_test(tests, LRU_CHURN);
+    suite_add_tcase(s, tests);
+}
@@ -0,0 +1,142 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <check.h>
+
+#include "list.h"
+#include "parallel.h"
+
+#define COUNT 10007
+
+typedef struct run {
+    /* The first and last values seen, and whether they were all in order. */
+    intptr_t first;
+    intptr_t last;
+    bool ordered;
+} run_t;
+
+static void count_visit(list_val_t value, void *ctx) {
+    atomic_fetch_add((atomic_llong *)ctx, (intptr_t)value);
+}
+
+static void thread_visit(list_val_t value, void *ctx) {
+    if (!pthread_equal(pthread_self(), *(pthread_t *)ctx)) {
+        *(pthread_t *)ctx = pthread_self();
+    }
+}
+
+static void sum_reduce(void *acc, list_val_t value, void *ctx) {
+    *(long long *)acc += (intptr_t)value;
+}
+
+static void sum_combine(void *acc, const void *other, void *ctx) {
+    *(long long *)acc += *(const long long *)other;
+}
+
+static void run_reduce(void *acc, list_val_t value, void *ctx) {
+    run_t *run = acc;
+    intptr_t v = (intptr_t)value;
+    if (run->first < 0) {
+        run->first = v;
+    } else if (v != run->last + 1) {
+        run->ordered = false;
+    }
+    run->last = v;
+}
+
+static void run_combine(void *acc, const void *other, void *ctx) {
+    run_t *run = acc;
+    const run_t *next = other;
+    if (next->first < 0) {
+        return;
+    }
+    if (run->first < 0) {
+        *run = *next;
+        return;
+    }
+    run->ordered = run->ordered && next->ordered && next->first == run->last + 1;
+    run->last = next->last;
+}
+
+static list_t *numbers(void) {
+    list_t *list = list_create();
+    for (intptr_t i = 1; i <= COUNT; i++) {
+        list_append(list, (list_val_t)i);
+    }
+    return list;
+}
+
+START_TEST(LIST_FOREACH_PARALLEL)
+{
+    list_t *list = numbers();
+    long long expected = (long long)COUNT * (COUNT + 1) / 2;
+
+    for (size_t threads = 0; threads <= 8; threads++) {
+        atomic_llong total = 0;
+        ck_assert(list_foreach_parallel(list, threads, count_visit, &total) == EXIT_SUCCESS);
+        ck_assert(total == expected);
+    }
+
+    ck_assert(list_anchors_enable(list, 64) == EXIT_SUCCESS);
+    atomic_llong total = 0;
+    ck_assert(list_foreach_parallel(list, 5, count_visit, &total) == EXIT_SUCCESS);
+    ck_assert(total == expected);
+
+    list_destroy(list, nullptr);
+
+    list = list_create();
+    total = 0;
+    ck_assert(list_foreach_parallel(list, 4, count_visit, &total) == EXIT_SUCCESS);
+    ck_assert(total == 0);
+
+    /* A short list isn't worth handing to other threads. */
+    for (intptr_t i = 0; i < 100; i++) {
+        list_append(list, (list_val_t)i);
+    }
+    pthread_t self = pthread_self();
+    ck_assert(list_foreach_parallel(list, 16, thread_visit, &self) == EXIT_SUCCESS);
+    ck_assert(pthread_equal(self, pthread_self()));
+    list_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_REDUCE_PARALLEL)
+{
+    list_t *list = numbers();
+
+    for (size_t threads = 1; threads <= 8; threads++) {
+        long long sum = 0;
+        ck_assert(list_reduce_parallel(list, threads, &sum, sizeof(sum), sum_reduce,
+                                       sum_combine, nullptr) == EXIT_SUCCESS);
+        ck_assert(sum == (long long)COUNT * (COUNT + 1) / 2);
+
+        /* Partial results are combined in list order. */
+        run_t run = { .first = -1, .last = -1, .ordered = true };
+        ck_assert(list_reduce_parallel(list, threads, &run, sizeof(run), run_reduce,
+                                       run_combine, nullptr) == EXIT_SUCCESS);
+        ck_assert(run.ordered);
+        ck_assert(run.first == 1 && run.last == COUNT);
+    }
+    list_destroy(list, nullptr);
+
+    /* More threads than elements. */
+    list = list_create();
+    list_append(list, (list_val_t)(intptr_t)5);
+    list_append(list, (list_val_t)(intptr_t)6);
+    long long sum = 0;
+    ck_assert(list_reduce_parallel(list, 16, &sum, sizeof(sum), sum_reduce, sum_combine,
+                                   nullptr) == EXIT_SUCCESS);
+    ck_assert(sum == 11);
+    list_destroy(list, nullptr);
+}
+END_TEST
+
+void parallel_tests (Suite *s) {
+    TCase *tests = tcase_create("parallel");
+    tcase_add_test(tests, LIST_FOREACH_PARALLEL);
+    tcase_add_test(tests, LIST_REDUCE_PARALLEL);
+    suite_add_tcase(s, tests);
+}
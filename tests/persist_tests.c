@@ -0,0 +1,175 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <check.h>
+
+#include "list.h"
+#include "persist.h"
+
+typedef struct record {
+    int64_t id;
+    char tag[16];
+} record_t;
+
+static void temp_path(char *path) {
+    strcpy(path, "/tmp/xorlist-XXXXXX");
+    int fd = mkstemp(path);
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+START_TEST(LIST_SAVE_LOAD)
+{
+    char path[32];
+    temp_path(path);
+
+    list_t *list = list_create_inline(sizeof(record_t));
+    for (int i = 0; i < 100; i++) {
+        record_t record = { .id = i * 3 };
+        snprintf(record.tag, sizeof(record.tag), "r%d", i);
+        ck_assert(list_append(list, &record) == EXIT_SUCCESS);
+    }
+    list_reverse(list);
+    ck_assert(list_save(list, path) == EXIT_SUCCESS);
+
+    list_t *loaded = list_load(path);
+    ck_assert(loaded);
+    ck_assert(list_size(*loaded) == 100);
+    for (size_t i = 0; i < 100; i++) {
+        record_t expected, actual;
+        ck_assert(list_get_into(*list, i, &expected) == EXIT_SUCCESS);
+        ck_assert(list_get_into(*loaded, i, &actual) == EXIT_SUCCESS);
+        ck_assert(expected.id == actual.id);
+        ck_assert(!strcmp(expected.tag, actual.tag));
+    }
+    /* The loaded list is an ordinary inline list. */
+    record_t extra = { .id = -1, .tag = "x" };
+    ck_assert(list_push(loaded, &extra) == EXIT_SUCCESS);
+    ck_assert(list_size(*loaded) == 101);
+
+    list_destroy(loaded, nullptr);
+    list_destroy(list, nullptr);
+    unlink(path);
+}
+END_TEST
+
+START_TEST(LIST_VIEW)
+{
+    char path[32];
+    temp_path(path);
+
+    list_t *list = list_create_inline(sizeof(int));
+    for (int i = 0; i < 50; i++) {
+        ck_assert(list_append(list, &i) == EXIT_SUCCESS);
+    }
+    ck_assert(list_save(list, path) == EXIT_SUCCESS);
+    list_destroy(list, nullptr);
+
+    list_view_t view;
+    ck_assert(list_view_open(&view, path) == EXIT_SUCCESS);
+    ck_assert(list_view_size(view) == 50);
+    for (int i = 0; i < 50; i++) {
+        const int *value = list_view_get(view, i);
+        ck_assert(value && *value == i);
+        ck_assert(list_view_find(view, &i) == i);
+    }
+    int missing = 50;
+    ck_assert(list_view_get(view, 50) == nullptr);
+    ck_assert(list_view_find(view, &missing) == -1);
+    list_view_close(&view);
+
+    list = list_create_inline(sizeof(int));
+    ck_assert(list_save(list, path) == EXIT_SUCCESS);
+    list_destroy(list, nullptr);
+    ck_assert(list_view_open(&view, path) == EXIT_SUCCESS);
+    ck_assert(list_view_size(view) == 0);
+    ck_assert(list_view_find(view, &missing) == -1);
+    list_view_close(&view);
+
+    unlink(path);
+}
+END_TEST
+
+START_TEST(LIST_SAVE_INVALID)
+{
+    char path[32];
+    temp_path(path);
+
+    /* Pointers can't be saved. */
+    list_t *list = list_create();
+    int value = 7;
+    ck_assert(list_append(list, &value) == EXIT_SUCCESS);
+    ck_assert(list_save(list, path) == EXIT_FAILURE);
+    list_destroy(list, nullptr);
+
+    /* Neither an empty file nor a truncated image loads. */
+    list_view_t view;
+    ck_assert(list_view_open(&view, path) == EXIT_FAILURE);
+    ck_assert(list_load(path) == nullptr);
+
+    list = list_create_inline(sizeof(int));
+    for (int i = 0; i < 10; i++) {
+        ck_assert(list_append(list, &i) == EXIT_SUCCESS);
+    }
+    ck_assert(list_save(list, path) == EXIT_SUCCESS);
+    list_destroy(list, nullptr);
+    ck_assert(truncate(path, 100) == 0);
+    ck_assert(list_view_open(&view, path) == EXIT_FAILURE);
+    ck_assert(list_load(path) == nullptr);
+
+    /*
+     * An element size that doesn't fit in the nodes is rejected. It comes
+     * right after the magic, version and byte order in the header.
+     */
+    list = list_create_inline(sizeof(int));
+    ck_assert(list_append(list, &value) == EXIT_SUCCESS);
+    ck_assert(list_save(list, path) == EXIT_SUCCESS);
+    list_destroy(list, nullptr);
+    FILE *file = fopen(path, "r+b");
+    ck_assert(file != nullptr);
+    uint64_t elem_size = UINT64_MAX - 7;
+    ck_assert(fseek(file, 16, SEEK_SET) == 0);
+    ck_assert(fwrite(&elem_size, sizeof(elem_size), 1, file) == 1);
+    ck_assert(fclose(file) == 0);
+    ck_assert(list_view_open(&view, path) == EXIT_FAILURE);
+    ck_assert(list_load(path) == nullptr);
+
+    /*
+     * A list whose links reach the tail early doesn't load as a shorter
+     * list. The 56 byte header is followed by 16 byte nodes, so point the
+     * second element straight from the first to the tail.
+     */
+    list = list_create_inline(sizeof(int));
+    for (int i = 0; i < 10; i++) {
+        ck_assert(list_append(list, &i) == EXIT_SUCCESS);
+    }
+    ck_assert(list_save(list, path) == EXIT_SUCCESS);
+    list_destroy(list, nullptr);
+    file = fopen(path, "r+b");
+    ck_assert(file != nullptr);
+    uint64_t link = (56 + 16) ^ (56 + 11 * 16);
+    ck_assert(fseek(file, 56 + 2 * 16, SEEK_SET) == 0);
+    ck_assert(fwrite(&link, sizeof(link), 1, file) == 1);
+    ck_assert(fclose(file) == 0);
+    ck_assert(list_load(path) == nullptr);
+
+    ck_assert(list_load("/nonexistent/xorlist") == nullptr);
+    unlink(path);
+}
+END_TEST
+
+void persist_tests (Suite *s) {
+    TCase *tests = tcase_create("persist");
+    tcase_add_test(tests, LIST_SAVE_LOAD);
+    tcase_add_test(tests, LIST_VIEW);
+    tcase_add_test(tests, LIST_SAVE_INVALID);
+    suite_add_tcase(s, tests);
+}
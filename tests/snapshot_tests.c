@@ -0,0 +1,226 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <check.h>
+
+#include "list.h"
+#include "snapshot.h"
+
+#define READERS 3
+#define ROUNDS 2000
+
+typedef struct shared {
+    list_publisher_t *pub;
+    atomic_bool done;
+    atomic_size_t errors;
+    atomic_size_t reads;
+} shared_t;
+
+static size_t destroyed = 0;
+
+static void count_destroy(list_val_t value) {
+    destroyed++;
+}
+
+static int *boxed(int value) {
+    int *box = malloc(sizeof(int));
+    *box = value;
+    return box;
+}
+
+/* Checks that a snapshot holds a run of consecutive boxed numbers. */
+static bool consecutive(list_t *snapshot) {
+    int expected = -1;
+    for (list_cursor_t cursor = list_cursor_begin(snapshot); list_cursor_valid(cursor);
+         list_cursor_next(&cursor)) {
+        int value = *(int *)list_cursor_get(cursor);
+        if (expected >= 0 && value != expected) {
+            return false;
+        }
+        expected = value + 1;
+    }
+    return true;
+}
+
+static void *reader(void *arg) {
+    shared_t *shared = arg;
+    ssize_t id = list_reader_register(shared->pub);
+    if (id < 0) {
+        atomic_fetch_add(&shared->errors, 1);
+        return nullptr;
+    }
+
+    while (!atomic_load(&shared->done)) {
+        list_t *snapshot = list_snapshot(shared->pub, id);
+        if (!consecutive(snapshot)) {
+            atomic_fetch_add(&shared->errors, 1);
+        }
+        list_snapshot_release(shared->pub, id);
+        atomic_fetch_add(&shared->reads, 1);
+    }
+
+    list_reader_unregister(shared->pub, id);
+    return nullptr;
+}
+
+START_TEST(LIST_SNAPSHOT)
+{
+    list_publisher_t *pub = list_publisher_create();
+    ck_assert(pub != nullptr);
+
+    ssize_t id = list_reader_register(pub);
+    ck_assert(id >= 0);
+    ck_assert(list_size(*list_snapshot(pub, id)) == 0);
+    list_snapshot_release(pub, id);
+
+    list_t *list = list_create();
+    for (intptr_t i = 0; i < 100; i++) {
+        list_append(list, (list_val_t)i);
+    }
+    ck_assert(list_publish(pub, list) == EXIT_SUCCESS);
+    ck_assert(pub->pending == 0);
+
+    /* A snapshot stays as it was while the writer carries on. */
+    list_t *snapshot = list_snapshot(pub, id);
+    ck_assert(list_size(*snapshot) == 100);
+    destroyed = 0;
+    for (size_t i = 0; i < 50; i++) {
+        ck_assert(list_retire(pub, list_pop(list), count_destroy) == EXIT_SUCCESS);
+    }
+    list_append(list, (list_val_t)(intptr_t)100);
+    ck_assert(list_publish(pub, list) == EXIT_SUCCESS);
+    ck_assert(list_publish(pub, list) == EXIT_SUCCESS);
+
+    ck_assert(destroyed == 0);
+    ck_assert(pub->pending == 52);
+    ck_assert(list_size(*snapshot) == 100);
+    ck_assert(list_get(*snapshot, 0) == (list_val_t)(intptr_t)0);
+    ck_assert(list_get(*snapshot, 99) == (list_val_t)(intptr_t)99);
+    ck_assert(list_find(*snapshot, (list_val_t)(intptr_t)100) == -1);
+
+    /* Releasing it lets the writer reclaim the old snapshots and elements. */
+    list_snapshot_release(pub, id);
+    ck_assert(list_reclaim(pub) == 52);
+    ck_assert(destroyed == 50);
+    ck_assert(pub->pending == 0);
+
+    snapshot = list_snapshot(pub, id);
+    ck_assert(list_size(*snapshot) == 51);
+    ck_assert(list_get(*snapshot, 0) == (list_val_t)(intptr_t)50);
+    ck_assert(list_get(*snapshot, 50) == (list_val_t)(intptr_t)100);
+    list_snapshot_release(pub, id);
+
+    /* Retired elements wait for the next publish even with no readers. */
+    ck_assert(list_retire(pub, list_pop(list), count_destroy) == EXIT_SUCCESS);
+    ck_assert(list_reclaim(pub) == 0);
+    ck_assert(list_publish(pub, list) == EXIT_SUCCESS);
+    ck_assert(destroyed == 51);
+    ck_assert(pub->pending == 0);
+
+    list_reader_unregister(pub, id);
+    list_destroy(list, nullptr);
+    list_publisher_destroy(pub);
+}
+END_TEST
+
+START_TEST(LIST_SNAPSHOT_INLINE)
+{
+    list_publisher_t *pub = list_publisher_create();
+    list_t *list = list_create_inline(sizeof(double));
+    for (int i = 0; i < 10; i++) {
+        double value = i / 2.0;
+        list_append(list, &value);
+    }
+    ck_assert(list_publish(pub, list) == EXIT_SUCCESS);
+
+    /* Elements are copied into the snapshot. */
+    double value = -1;
+    list_set(list, 3, &value);
+
+    ssize_t id = list_reader_register(pub);
+    list_t *snapshot = list_snapshot(pub, id);
+    double out;
+    ck_assert(list_size(*snapshot) == 10);
+    ck_assert(list_get_into(*snapshot, 3, &out) == EXIT_SUCCESS);
+    ck_assert(out == 1.5);
+    ck_assert(list_find(*snapshot, &value) == -1);
+    list_snapshot_release(pub, id);
+    list_reader_unregister(pub, id);
+
+    list_destroy(list, nullptr);
+    list_publisher_destroy(pub);
+}
+END_TEST
+
+START_TEST(LIST_SNAPSHOT_READERS)
+{
+    list_publisher_t *pub = list_publisher_create();
+
+    for (ssize_t i = 0; i < LIST_PUBLISHER_MAX_READERS; i++) {
+        ck_assert(list_reader_register(pub) == i);
+    }
+    ck_assert(list_reader_register(pub) == -1);
+
+    list_reader_unregister(pub, 7);
+    ck_assert(list_reader_register(pub) == 7);
+
+    /* Leftover elements are destroyed along with the publisher. */
+    destroyed = 0;
+    list_retire(pub, nullptr, count_destroy);
+    list_publisher_destroy(pub);
+    ck_assert(destroyed == 1);
+}
+END_TEST
+
+START_TEST(LIST_SNAPSHOT_CONCURRENT)
+{
+    shared_t shared = { .pub = list_publisher_create() };
+    atomic_init(&shared.done, false);
+    atomic_init(&shared.errors, 0);
+    atomic_init(&shared.reads, 0);
+
+    pthread_t threads[READERS];
+    for (size_t i = 0; i < READERS; i++) {
+        ck_assert(pthread_create(&threads[i], nullptr, reader, &shared) == 0);
+    }
+
+    /*
+     * Keep a sliding window of boxed numbers, freeing the ones that drop out
+     * only once no reader can see them.
+     */
+    list_t *list = list_create();
+    for (int i = 0; i < ROUNDS; i++) {
+        list_append(list, boxed(i));
+        if (list_size(*list) > 64) {
+            list_retire(shared.pub, list_pop(list), free);
+        }
+        ck_assert(list_publish(shared.pub, list) == EXIT_SUCCESS);
+    }
+
+    atomic_store(&shared.done, true);
+    for (size_t i = 0; i < READERS; i++) {
+        pthread_join(threads[i], nullptr);
+    }
+
+    ck_assert(atomic_load(&shared.errors) == 0);
+    ck_assert(atomic_load(&shared.reads) > 0);
+    list_reclaim(shared.pub);
+    ck_assert(shared.pub->pending == 0);
+
+    list_destroy(list, free);
+    list_publisher_destroy(shared.pub);
+}
+END_TEST
+
+void snapshot_tests (Suite *s) {
+    TCase *tests = tcase_create("snapshot");
+    tcase_add_test(tests, LIST_SNAPSHOT);
+    tcase_add_test(tests, LIST_SNAPSHOT_INLINE);
+    tcase_add_test(tests, LIST_SNAPSHOT_READERS);
+    tcase_add_test(tests, LIST_SNAPSHOT_CONCURRENT);
+    suite_add_tcase(s, tests);
+}
@@ -1,6 +1,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <check.h>
 
@@ -15,6 +16,10 @@ void destroy_counter(list_val_t _) {
     destroy_count += 1;
 }
 
+static bool is_multiple(list_val_t value, void *divisor) {
+    return ((data_t *)value)->val % *(int *)divisor == 0;
+}
+
 START_TEST(LIST_CREATE)
 {
     list_t *list = list_create();
@@ -26,6 +31,79 @@ START_TEST(LIST_CREATE)
 }
 END_TEST
 
+START_TEST(LIST_INIT)
+{
+    list_t list;
+    list_init(&list);
+    ck_assert(list_is_empty(list));
+
+    data_t values[10];
+    for (int i = 0; i < 10; i++) {
+        values[i] = (data_t){ .val = i };
+        ck_assert(!list_append(&list, values + i));
+    }
+    list_reverse(&list);
+    for (int i = 0; i < 10; i++) {
+        ck_assert(list_get(list, i) == values + (9 - i));
+    }
+
+    destroy_count = 0;
+    list_fini(&list, destroy_counter);
+    ck_assert(destroy_count == 10);
+    destroy_count = 0;
+
+    /* The storage can be reused for a new list. */
+    list_init(&list);
+    ck_assert(!list_push(&list, values));
+    ck_assert(list_pop(&list) == values);
+    list_fini(&list, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_CREATE_WITH_POOL)
+{
+    list_t *list = list_create_with_pool(4);
+    ck_assert(list);
+    ck_assert(list->pool);
+    ck_assert(list->size == 0);
+
+    data_t values[10];
+    for (int i = 0; i < 10; i++) {
+        values[i] = (data_t){ .val = i };
+        ck_assert(!list_append(list, values + i));
+    }
+
+    for (int i = 0; i < 10; i++) {
+        ck_assert(list_get(*list, i) == values + i);
+    }
+
+    list_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_POOL_REUSE)
+{
+    list_t *list = list_create_with_pool(2);
+    data_t values[100];
+
+    /* Churn through far more nodes than the pool ever holds at once. */
+    for (int i = 0; i < 100; i++) {
+        values[i] = (data_t){ .val = i };
+        ck_assert(!list_enqueue(list, values + i));
+        if (i >= 3) {
+            ck_assert(list_dequeue(list) == values + (i - 3));
+        }
+    }
+
+    ck_assert(list_size(*list) == 3);
+    for (int i = 97; i < 100; i++) {
+        ck_assert(list_dequeue(list) == values + i);
+    }
+
+    list_destroy(list, nullptr);
+}
+END_TEST
+
 START_TEST(LIST_DESTROY)
 {
     list_t *list = list_create();
@@ -54,6 +132,101 @@ START_TEST(LIST_DESTROY_FREE)
 }
 END_TEST
 
+static intptr_t destroyed[64];
+static size_t destroyed_count = 0;
+static void record_destroy(list_val_t value) {
+    destroyed[destroyed_count++] = (intptr_t)value;
+}
+
+START_TEST(LIST_DESTROY_ORDER)
+{
+    /* Elements are destroyed front to back, whichever way the list points. */
+    list_t *list = list_create();
+    for (intptr_t i = 0; i < 10; i++) list_append(list, (list_val_t)i);
+    list_reverse(list);
+    destroyed_count = 0;
+    list_destroy(list, record_destroy);
+    ck_assert(destroyed_count == 10);
+    for (size_t i = 0; i < 10; i++) {
+        ck_assert(destroyed[i] == 9 - (intptr_t)i);
+    }
+
+    /* Nodes of a shared pool go back to it for the other list to reuse. */
+    list = list_create_with_pool(8);
+    for (intptr_t i = 0; i < 20; i++) list_append(list, (list_val_t)i);
+    list_t *rest = list_split(list, 10);
+    destroyed_count = 0;
+    list_destroy(rest, record_destroy);
+    ck_assert(destroyed_count == 10);
+    ck_assert(destroyed[0] == 10 && destroyed[9] == 19);
+    for (intptr_t i = 0; i < 10; i++) ck_assert(!list_append(list, (list_val_t)i));
+    destroyed_count = 0;
+    list_destroy(list, record_destroy);
+    ck_assert(destroyed_count == 20);
+
+    list_t local;
+    list_init(&local);
+    list_fini(&local, record_destroy);
+}
+END_TEST
+
+START_TEST(LIST_DESTROY_ASYNC)
+{
+    destroy_count = 0;
+    size_t expected = 0;
+
+    list_t *list = list_create();
+    for (size_t i = 0; i < 1000; i++) list_append(list, malloc(sizeof(int)));
+    list_destroy_async(list, free);
+
+    list = list_create_with_pool(0);
+    for (size_t i = 0; i < 1000; i++) list_append(list, nullptr);
+    ck_assert(list_anchors_enable(list, 16) == EXIT_SUCCESS);
+    ck_assert(list_hash_enable(list) == EXIT_SUCCESS);
+    list_reverse(list);
+    list_destroy_async(list, destroy_counter);
+    expected += 1000;
+
+    list = list_create_inline(sizeof(data_t));
+    for (int i = 0; i < 3; i++) list_append(list, &(data_t){ .val = i });
+    list_destroy_async(list, destroy_counter);
+    expected += 3;
+
+    list = list_create();
+    list_append(list, nullptr);
+    list_destroy_async(list, destroy_counter);
+    expected += 1;
+
+    list_destroy_async(list_create(), destroy_counter);
+    list_destroy_async(list_create_with_pool(0), nullptr);
+
+    list_destroy_async_wait();
+    ck_assert(destroy_count == expected);
+
+    /* A list sharing its pool is torn down right away. */
+    list = list_create_with_pool(0);
+    for (size_t i = 0; i < 10; i++) list_append(list, nullptr);
+    list_t *rest = list_split(list, 5);
+    destroy_count = 0;
+    list_destroy_async(rest, destroy_counter);
+    ck_assert(destroy_count == 5);
+    list_destroy_async(list, destroy_counter);
+    list_destroy_async_wait();
+    ck_assert(destroy_count == 10);
+
+    /* A list set up with list_init is left to the caller. */
+    list_t local;
+    list_init(&local);
+    for (size_t i = 0; i < 10; i++) list_append(&local, nullptr);
+    destroy_count = 0;
+    list_fini_async(&local, destroy_counter);
+    ck_assert(local.size == 0 && local.head == nullptr && local.pool == nullptr);
+    list_destroy_async_wait();
+    ck_assert(destroy_count == 10);
+    destroy_count = 0;
+}
+END_TEST
+
 START_TEST(LIST_INSERT)
 {
     list_t *list = list_create();
@@ -348,6 +521,290 @@ START_TEST(LIST_REMOVE)
 }
 END_TEST
 
+START_TEST(LIST_REMOVE_IF)
+{
+    list_t *list = list_create();
+
+    data_t values[50];
+    for (int i = 0; i < 50; i++) {
+        values[i] = (data_t) { .val = i };
+        list_append(list, values + i);
+    }
+    ck_assert(list_anchors_enable(list, 4) == EXIT_SUCCESS);
+    ck_assert(list_hash_enable(list) == EXIT_SUCCESS);
+
+    /* Remove the multiples of 3, including the first and the last. */
+    int divisor = 3;
+    destroy_count = 0;
+    ck_assert(list_remove_if(list, is_multiple, &divisor, destroy_counter) == 17);
+    ck_assert(destroy_count == 17);
+    ck_assert(list_size(*list) == 33);
+    for (size_t i = 0; i < list_size(*list); i++) {
+        data_t *value = list_get(*list, i);
+        ck_assert(value->val % 3 != 0);
+        ck_assert(value->val == (int)(i / 2 * 3 + i % 2 + 1));
+    }
+    ck_assert(!list_contains(*list, values + 3));
+    ck_assert(list_contains(*list, values + 4));
+
+    /* Keep only the even values. */
+    divisor = 2;
+    ck_assert(list_retain(list, is_multiple, &divisor, nullptr) == 17);
+    ck_assert(list_size(*list) == 16);
+    for (size_t i = 0; i < list_size(*list); i++) {
+        data_t *value = list_get(*list, i);
+        ck_assert(value->val % 2 == 0 && value->val % 3 != 0);
+    }
+    ck_assert(list_remove_if(list, is_multiple, &divisor, nullptr) == 16);
+    ck_assert(list_is_empty(*list));
+    ck_assert(list_remove_if(list, is_multiple, &divisor, nullptr) == 0);
+
+    list_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_INSERT_MANY)
+{
+    data_t values[100];
+    list_val_t items[100];
+    for (int i = 0; i < 100; i++) {
+        values[i] = (data_t){ .val = i };
+        items[i] = values + i;
+    }
+
+    list_t *lists[] = { list_create(), list_create_with_pool(8) };
+    for (size_t l = 0; l < 2; l++) {
+        list_t *list = lists[l];
+        ck_assert(list_anchors_enable(list, 8) == EXIT_SUCCESS);
+
+        /* 0..9 and 90..99, then 10..89 in between. */
+        ck_assert(list_extend(list, items, 10) == EXIT_SUCCESS);
+        ck_assert(list_extend(list, items + 90, 10) == EXIT_SUCCESS);
+        ck_assert(list_insert_many(list, 10, items + 10, 80) == EXIT_SUCCESS);
+        ck_assert(list_insert_many(list, 101, items, 1) == EXIT_FAILURE);
+        ck_assert(list_insert_many(list, 100, items, 0) == EXIT_SUCCESS);
+        ck_assert(list_size(*list) == 100);
+
+        for (size_t i = 0; i < 100; i++) {
+            ck_assert(list_get(*list, i) == items[i]);
+        }
+
+        /* The list still works normally around the new nodes. */
+        ck_assert(list_delete(list, 50) == items[50]);
+        ck_assert(list_insert(list, 50, items[50]) == EXIT_SUCCESS);
+        ck_assert(list_get(*list, 99) == items[99]);
+
+        list_destroy(list, nullptr);
+    }
+
+    /* A pooled list takes the whole batch from a single new slab. */
+    list_t *list = list_create_with_pool(8);
+    struct list_stats stats;
+    ck_assert(list_extend(list, items, 100) == EXIT_SUCCESS);
+    if (!list_stats(list, &stats)) {
+        ck_assert(stats.allocs == 1);
+        ck_assert(stats.inserts == 100);
+    }
+    list_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_ARRAY)
+{
+    data_t values[20];
+    list_val_t items[20];
+    for (int i = 0; i < 20; i++) {
+        values[i] = (data_t){ .val = i };
+        items[i] = values + i;
+    }
+
+    list_t *list = list_from_array(items, 20);
+    ck_assert(list);
+    ck_assert(list_size(*list) == 20);
+
+    list_val_t out[25] = { 0 };
+    ck_assert(list_to_array(*list, out, 25) == 20);
+    for (int i = 0; i < 20; i++) {
+        ck_assert(out[i] == items[i]);
+    }
+    ck_assert(out[20] == nullptr);
+
+    ck_assert(list_to_array(*list, out, 5) == 5);
+    list_destroy(list, nullptr);
+
+    list = list_from_array(nullptr, 0);
+    ck_assert(list && list_is_empty(*list));
+    ck_assert(list_to_array(*list, out, 25) == 0);
+    list_destroy(list, nullptr);
+}
+END_TEST
+
+static bool contiguous(list_t *list) {
+    list_cursor_t cursor = list_cursor_begin(list);
+    if (!list_cursor_valid(cursor)) {
+        return true;
+    }
+
+    node_t *first = cursor.curr;
+    list_cursor_next(&cursor);
+    if (!list_cursor_valid(cursor)) {
+        return true;
+    }
+
+    ptrdiff_t stride = (char *)cursor.curr - (char *)first;
+    node_t *prev = cursor.curr;
+    while (list_cursor_next(&cursor)) {
+        if ((char *)cursor.curr - (char *)prev != stride) {
+            return false;
+        }
+        prev = cursor.curr;
+    }
+    return stride > 0;
+}
+
+START_TEST(LIST_COMPACT)
+{
+    data_t values[300];
+    for (int i = 0; i < 300; i++) {
+        values[i] = (data_t){ .val = i };
+    }
+
+    /* Scatter the nodes by interleaving insertions at both ends with removals. */
+    list_t *list = list_create();
+    for (int i = 0; i < 300; i++) {
+        if (i % 2) {
+            list_append(list, values + i);
+        } else {
+            list_prepend(list, values + i);
+        }
+        if (i % 3 == 2) {
+            list_delete(list, list_size(*list) / 2);
+        }
+    }
+    ck_assert(list_anchors_enable(list, 16) == EXIT_SUCCESS);
+    ck_assert(list_hash_enable(list) == EXIT_SUCCESS);
+    list_reverse(list);
+
+    size_t size = list_size(*list);
+    list_val_t before[300];
+    ck_assert(list_to_array(*list, before, 300) == size);
+
+    ck_assert(list_compact(list) == EXIT_SUCCESS);
+    ck_assert(contiguous(list));
+    ck_assert(list_size(*list) == size);
+    for (size_t i = 0; i < size; i++) {
+        ck_assert(list_get(*list, i) == before[i]);
+        ck_assert(list_find(*list, before[i]) == (ssize_t)i);
+    }
+    ck_assert(list_cursor_get(list_cursor_end(list)) == before[size - 1]);
+
+    /* The hash index and the list keep working on the new nodes. */
+    ck_assert(list_discard(list, before[10]));
+    ck_assert(list_move_to_front(list, before[20]));
+    ck_assert(list_get(*list, 0) == before[20]);
+    ck_assert(list_append(list, values) == EXIT_SUCCESS);
+    ck_assert(list_size(*list) == size);
+    list_destroy(list, nullptr);
+
+    /* Empty lists, inline lists, and lists sharing a pool. */
+    list = list_create();
+    ck_assert(list_compact(list) == EXIT_SUCCESS);
+    ck_assert(list_is_empty(*list));
+    ck_assert(list_append(list, values) == EXIT_SUCCESS);
+    list_destroy(list, nullptr);
+
+    list = list_create_inline(sizeof(data_t));
+    for (int i = 0; i < 50; i++) {
+        list_prepend(list, values + i);
+    }
+    ck_assert(list_compact(list) == EXIT_SUCCESS);
+    ck_assert(contiguous(list));
+    for (int i = 0; i < 50; i++) {
+        ck_assert(((data_t *)list_get(*list, i))->val == 49 - i);
+    }
+    list_destroy(list, nullptr);
+
+    list = list_create_with_pool(4);
+    for (int i = 0; i < 50; i++) {
+        list_append(list, values + i);
+    }
+    list_t *rest = list_split(list, 25);
+    ck_assert(list_compact(list) == EXIT_SUCCESS);
+    ck_assert(contiguous(list));
+    for (int i = 0; i < 25; i++) {
+        ck_assert(list_get(*list, i) == values + i);
+        ck_assert(list_get(*rest, i) == values + 25 + i);
+    }
+    ck_assert(list_append(rest, values) == EXIT_SUCCESS);
+    list_destroy(rest, nullptr);
+    list_destroy(list, nullptr);
+
+    /* A compacted list can still be joined with plain lists. */
+    list = list_create();
+    for (int i = 0; i < 20; i++) {
+        list_append(list, values + i);
+    }
+    ck_assert(list_compact(list) == EXIT_SUCCESS);
+    list_t *plain = list_create();
+    list_append(plain, values + 100);
+    ck_assert(list_concat(plain, list) == EXIT_SUCCESS);
+    ck_assert(list_is_empty(*list));
+    ck_assert(list_size(*plain) == 21);
+    for (int i = 0; i < 20; i++) {
+        ck_assert(list_get(*plain, i + 1) == values + i);
+    }
+    ck_assert(list_concat(list, plain) == EXIT_SUCCESS);
+    ck_assert(list_size(*list) == 21);
+    ck_assert(list_get(*list, 0) == values + 100);
+
+    /* An empty plain list takes the nodes as they are. */
+    node_t *node = list_cursor_begin(list).curr;
+    ck_assert(list_concat(plain, list) == EXIT_SUCCESS);
+    ck_assert(list_cursor_begin(plain).curr == node);
+    ck_assert(list_append(plain, values) == EXIT_SUCCESS);
+    list_destroy(plain, nullptr);
+    list_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_COMPACT_AUTO)
+{
+    data_t values[100];
+    list_t *list = list_create();
+    for (int i = 0; i < 100; i++) {
+        values[i] = (data_t){ .val = i };
+        list_append(list, values + i);
+    }
+
+    /* A list without a pool gets one as soon as it's enabled. */
+    list_compact_auto(list, 10);
+    ck_assert(list->pool);
+    ck_assert(contiguous(list));
+    for (int i = 0; i < 9; i++) {
+        list_delete(list, 0);
+    }
+    ck_assert(list->churn == 9);
+    ck_assert(list_remove(list, values + 50) == 41);
+    ck_assert(list->churn == 0);
+    ck_assert(contiguous(list));
+
+    /* Removals through a cursor don't compact. */
+    list_cursor_t cursor = list_cursor_begin(list);
+    for (int i = 0; i < 20; i++) {
+        list_cursor_delete(&cursor);
+    }
+    ck_assert(list->churn == 20);
+    ck_assert(list_size(*list) == 70);
+    ck_assert(list_get(*list, 0) == values + 29);
+
+    list_compact_auto(list, 0);
+    list_delete(list, 0);
+    ck_assert(list->churn == 21);
+
+    list_destroy(list, nullptr);
+}
+END_TEST
+
 
 START_TEST(LIST_FIND)
 {
@@ -411,18 +868,736 @@ START_TEST(LIST_REVERSE)
 }
 END_TEST
 
+START_TEST(LIST_INSERT_END)
+{
+    list_t *list = list_create();
+    data_t values[5];
+
+    for (int i = 0; i < 5; i++) {
+        values[i] = (data_t){ .val = i };
+        ck_assert(!list_insert(list, i, values + i));
+    }
+
+    for (int i = 0; i < 5; i++) {
+        ck_assert(list_get(*list, i) == values + i);
+    }
+
+    ck_assert(list_delete(list, 5) == nullptr);
+    ck_assert(list_set(list, 5, values) == nullptr);
+    ck_assert(list_size(*list) == 5);
+
+    list_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_CURSOR_TRAVERSE)
+{
+    list_t *list = list_create();
+    data_t values[10];
+
+    list_cursor_t cursor = list_cursor_begin(list);
+    ck_assert(!list_cursor_valid(cursor));
+    cursor = list_cursor_end(list);
+    ck_assert(!list_cursor_valid(cursor));
+
+    for (int i = 0; i < 10; i++) {
+        values[i] = (data_t){ .val = i };
+        list_append(list, values + i);
+    }
+
+    int seen = 0;
+    for (cursor = list_cursor_begin(list); list_cursor_valid(cursor); list_cursor_next(&cursor)) {
+        ck_assert(cursor.idx == seen);
+        ck_assert(list_cursor_get(cursor) == values + seen);
+        seen++;
+    }
+    ck_assert(seen == 10);
+    ck_assert(!list_cursor_next(&cursor));
+
+    for (cursor = list_cursor_end(list); list_cursor_valid(cursor); list_cursor_prev(&cursor)) {
+        seen--;
+        ck_assert(cursor.idx == seen);
+        ck_assert(list_cursor_get(cursor) == values + seen);
+    }
+    ck_assert(seen == 0);
+    ck_assert(cursor.idx == -1);
+    ck_assert(!list_cursor_prev(&cursor));
+    ck_assert(list_cursor_next(&cursor));
+    ck_assert(list_cursor_get(cursor) == values);
+
+    cursor = list_cursor_at(list, 7);
+    ck_assert(list_cursor_get(cursor) == values + 7);
+    ck_assert(list_cursor_prev(&cursor));
+    ck_assert(list_cursor_get(cursor) == values + 6);
+
+    list_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_CURSOR_MODIFY)
+{
+    list_t *list = list_create();
+    data_t values[10];
+    for (int i = 0; i < 10; i++) {
+        values[i] = (data_t){ .val = i };
+    }
+
+    list_cursor_t cursor = list_cursor_begin(list);
+    ck_assert(!list_cursor_insert_before(&cursor, values + 1));
+    ck_assert(!list_cursor_insert_before(&cursor, values + 3));
+    ck_assert(cursor.idx == 2);
+
+    cursor = list_cursor_begin(list);
+    ck_assert(!list_cursor_insert_after(&cursor, values + 2));
+    cursor = list_cursor_at(list, 0);
+    list_cursor_prev(&cursor);
+    ck_assert(!list_cursor_insert_after(&cursor, values + 0));
+    ck_assert(list_cursor_insert_before(&cursor, values + 9));
+
+    for (int i = 0; i < 4; i++) {
+        ck_assert(list_get(*list, i) == values + i);
+    }
+
+    cursor = list_cursor_at(list, 1);
+    ck_assert(list_cursor_set(&cursor, values + 5) == values + 1);
+    ck_assert(list_cursor_delete(&cursor) == values + 5);
+    ck_assert(list_cursor_get(cursor) == values + 2);
+    ck_assert(list_cursor_delete(&cursor) == values + 2);
+    ck_assert(list_cursor_delete(&cursor) == values + 3);
+    ck_assert(!list_cursor_valid(cursor));
+    ck_assert(list_cursor_delete(&cursor) == nullptr);
+
+    ck_assert(list_size(*list) == 1);
+    ck_assert(list_peek(*list) == values);
+
+    list_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_ANCHORS)
+{
+    list_t *list = list_create();
+    data_t values[64];
+    list_val_t expected[512];
+    size_t size = 0;
+
+    ck_assert(list_anchors_enable(list, 0));
+    ck_assert(!list_anchors_enable(list, 3));
+
+    for (int i = 0; i < 64; i++) {
+        values[i] = (data_t){ .val = i };
+    }
+
+    /* Mix every kind of change, checking each index after every step. */
+    for (int round = 0; round < 400; round++) {
+        int op = rand() % 10;
+        size_t idx = size > 0 ? rand() % size : 0;
+        list_val_t value = values + (rand() % 64);
+
+        if (op < 4 || size == 0) {
+            idx = rand() % (size + 1);
+            ck_assert(!list_insert(list, idx, value));
+            memmove(expected + idx + 1, expected + idx, (size - idx) * sizeof(list_val_t));
+            expected[idx] = value;
+            size++;
+        } else if (op < 7) {
+            ck_assert(list_delete(list, idx) == expected[idx]);
+            memmove(expected + idx, expected + idx + 1, (size - idx - 1) * sizeof(list_val_t));
+            size--;
+        } else if (op < 8) {
+            list_cursor_t cursor = list_cursor_at(list, idx);
+            ck_assert(!list_cursor_insert_after(&cursor, value));
+            memmove(expected + idx + 2, expected + idx + 1, (size - idx - 1) * sizeof(list_val_t));
+            expected[idx + 1] = value;
+            size++;
+        } else if (op < 9) {
+            list_cursor_t cursor = list_cursor_at(list, idx);
+            ck_assert(list_cursor_delete(&cursor) == expected[idx]);
+            memmove(expected + idx, expected + idx + 1, (size - idx - 1) * sizeof(list_val_t));
+            size--;
+        } else {
+            list_reverse(list);
+            for (size_t i = 0; i < size / 2; i++) {
+                list_val_t tmp = expected[i];
+                expected[i] = expected[size - 1 - i];
+                expected[size - 1 - i] = tmp;
+            }
+        }
+
+        ck_assert(list_size(*list) == size);
+        for (size_t i = 0; i < size; i++) {
+            ck_assert(list_get(*list, i) == expected[i]);
+        }
+    }
+
+    list_anchors_disable(list);
+    for (size_t i = 0; i < size; i++) {
+        ck_assert(list_get(*list, i) == expected[i]);
+    }
+
+    list_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_CONCAT)
+{
+    list_t *first = list_create();
+    list_t *second = list_create();
+    data_t values[20];
+
+    for (int i = 0; i < 20; i++) {
+        values[i] = (data_t){ .val = i };
+        list_append(i < 10 ? first : second, values + i);
+    }
+    list_reverse(second);
+
+    node_t *node = list_cursor_begin(second).curr;
+    ck_assert(!list_concat(first, second));
+    ck_assert(list_is_empty(*second));
+    ck_assert(list_size(*first) == 20);
+
+    /* The nodes themselves were moved. */
+    ck_assert(list_cursor_at(first, 10).curr == node);
+
+    for (int i = 0; i < 10; i++) {
+        ck_assert(list_get(*first, i) == values + i);
+        ck_assert(list_get(*first, 10 + i) == values + (19 - i));
+    }
+
+    /* The emptied list is still usable. */
+    ck_assert(!list_append(second, values));
+    ck_assert(list_peek(*second) == values);
+    ck_assert(list_concat(first, first));
+
+    list_destroy(first, nullptr);
+    list_destroy(second, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_SPLICE)
+{
+    list_t *dst = list_create_with_pool(4);
+    list_t *src = list_create();
+    data_t values[20];
+
+    for (int i = 0; i < 20; i++) {
+        values[i] = (data_t){ .val = i };
+        list_append(i < 5 || i >= 15 ? dst : src, values + i);
+    }
+
+    ck_assert(list_splice(dst, 11, src, 0, 1));
+    ck_assert(list_splice(dst, 0, src, 5, 6));
+    ck_assert(!list_splice(dst, 5, src, 0, 0));
+
+    /* Differently allocated lists have their items moved one by one. */
+    ck_assert(!list_splice(dst, 5, src, 0, 10));
+    ck_assert(list_is_empty(*src));
+    ck_assert(list_size(*dst) == 20);
+
+    list_t *pooled = list_split(dst, 5);
+    ck_assert(pooled);
+    ck_assert(list_size(*pooled) == 15);
+    ck_assert(list_size(*dst) == 5);
+
+    /* Lists sharing a pool have their nodes relinked. */
+    node_t *node = list_cursor_at(pooled, 3).curr;
+    ck_assert(!list_splice(dst, 5, pooled, 3, 4));
+    ck_assert(list_cursor_at(dst, 5).curr == node);
+    ck_assert(!list_splice(dst, 5, pooled, 0, 3));
+    ck_assert(!list_splice(dst, 12, pooled, 0, 8));
+    ck_assert(list_is_empty(*pooled));
+
+    for (int i = 0; i < 20; i++) {
+        ck_assert(list_get(*dst, i) == values + i);
+    }
+
+    list_destroy(pooled, nullptr);
+    list_destroy(dst, nullptr);
+    list_destroy(src, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_SPLICE_POOLS)
+{
+    /* Independently pooled lists merge their pools and relink nodes. */
+    list_t *workers[4];
+    list_t *siblings[4];
+    intptr_t next = 0;
+    for (size_t w = 0; w < 4; w++) {
+        workers[w] = list_create_with_pool(3);
+        for (int i = 0; i < 10; i++) list_append(workers[w], (list_val_t)next++);
+        siblings[w] = list_split(workers[w], 8);
+    }
+
+    list_t *results = list_create();
+    for (size_t w = 0; w < 4; w++) {
+        node_t *node = list_cursor_begin(workers[w]).curr;
+        ck_assert(!list_concat(results, workers[w]));
+        ck_assert(list_cursor_at(results, w * 8).curr == node);
+        ck_assert(list_is_empty(*workers[w]));
+    }
+    ck_assert(list_size(*results) == 32);
+    for (size_t i = 0; i < 32; i++) {
+        ck_assert(list_get(*results, i) == (list_val_t)(intptr_t)(i / 8 * 10 + i % 8));
+    }
+
+    /* Lists still holding a merged pool keep working, in any order. */
+    for (size_t w = 0; w < 4; w++) {
+        ck_assert(!list_append(siblings[w], (list_val_t)next++));
+        ck_assert(!list_append(workers[w], (list_val_t)next++));
+        list_destroy(w % 2 ? workers[w] : siblings[w], nullptr);
+    }
+    ck_assert(!list_concat(results, siblings[1]));
+    ck_assert(!list_splice(results, 0, workers[0], 0, 1));
+    ck_assert(list_size(*results) == 36);
+    list_destroy(results, nullptr);
+    for (size_t w = 0; w < 4; w++) {
+        list_destroy(w % 2 ? siblings[w] : workers[w], nullptr);
+    }
+
+    /* Inline lists merge the same way, and the move is all or nothing. */
+    list_t *dst = list_create_inline_with_pool(sizeof(data_t), 2);
+    list_t *src = list_create_inline_with_pool(sizeof(data_t), 5);
+    for (int i = 0; i < 6; i++) list_append(i < 3 ? dst : src, &(data_t){ .val = i });
+    ck_assert(!list_splice(dst, 1, src, 1, 2));
+    ck_assert(list_size(*dst) == 5 && list_size(*src) == 1);
+    int expected[] = {0, 4, 5, 1, 2};
+    for (size_t i = 0; i < 5; i++) {
+        ck_assert(((data_t *)list_get(*dst, i))->val == expected[i]);
+    }
+    list_destroy(src, nullptr);
+    list_destroy(dst, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_SPLIT)
+{
+    list_t *list = list_create_with_pool(2);
+    data_t values[10];
+
+    for (int i = 0; i < 10; i++) {
+        values[i] = (data_t){ .val = i };
+        list_append(list, values + i);
+    }
+
+    ck_assert(list_split(list, 11) == nullptr);
+
+    list_t *rest = list_split(list, 4);
+    list_t *none = list_split(rest, 6);
+    ck_assert(list_size(*list) == 4);
+    ck_assert(list_size(*rest) == 6);
+    ck_assert(list_is_empty(*none));
+
+    for (int i = 0; i < 4; i++) {
+        ck_assert(list_get(*list, i) == values + i);
+    }
+    for (int i = 0; i < 6; i++) {
+        ck_assert(list_get(*rest, i) == values + 4 + i);
+    }
+
+    /* The pool outlives the list it was created for. */
+    list_destroy(list, nullptr);
+    ck_assert(!list_append(none, values));
+    ck_assert(!list_concat(rest, none));
+    ck_assert(list_get(*rest, 6) == values);
+
+    list_destroy(none, nullptr);
+    list_destroy(rest, nullptr);
+}
+END_TEST
+
+static int compare_data(list_val_t a, list_val_t b) {
+    return ((data_t *)a)->val - ((data_t *)b)->val;
+}
+
+START_TEST(LIST_SORT)
+{
+    list_t *list = list_create();
+    data_t values[1000];
+
+    list_sort(list, compare_data);
+    ck_assert(list_is_empty(*list));
+
+    /* Lots of duplicate keys, so stability can be checked by address. */
+    for (int i = 0; i < 1000; i++) {
+        values[i] = (data_t){ .val = rand() % 50 };
+        list_append(list, values + i);
+    }
+    list_reverse(list);
+    list_reverse(list);
+
+    list_sort(list, compare_data);
+    ck_assert(list_size(*list) == 1000);
+
+    data_t *prev = nullptr;
+    list_cursor_t cursor;
+    for (cursor = list_cursor_begin(list); list_cursor_valid(cursor); list_cursor_next(&cursor)) {
+        data_t *curr = list_cursor_get(cursor);
+        if (prev) {
+            ck_assert(prev->val < curr->val || (prev->val == curr->val && prev < curr));
+        }
+        prev = curr;
+    }
+
+    /* The links in the other direction must be intact too. */
+    data_t *next = nullptr;
+    for (cursor = list_cursor_end(list); list_cursor_valid(cursor); list_cursor_prev(&cursor)) {
+        data_t *curr = list_cursor_get(cursor);
+        if (next) {
+            ck_assert(curr->val < next->val || (curr->val == next->val && curr < next));
+        }
+        next = curr;
+    }
+    ck_assert(next == list_peek(*list));
+
+    list_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_INSERT_SORTED)
+{
+    list_t *list = list_create();
+    data_t values[6] = { { 3 }, { 1 }, { 2 }, { 3 }, { 0 }, { 5 } };
+
+    for (int i = 0; i < 6; i++) {
+        ck_assert(!list_insert_sorted(list, values + i, compare_data));
+    }
+
+    ck_assert(list_get(*list, 0) == values + 4);
+    ck_assert(list_get(*list, 1) == values + 1);
+    ck_assert(list_get(*list, 2) == values + 2);
+    ck_assert(list_get(*list, 3) == values + 0);
+    ck_assert(list_get(*list, 4) == values + 3);
+    ck_assert(list_get(*list, 5) == values + 5);
+
+    list_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_MERGE_SORTED)
+{
+    list_t *dst = list_create();
+    list_t *src = list_create();
+    data_t values[20];
+
+    for (int i = 0; i < 20; i++) {
+        values[i] = (data_t){ .val = i / 2 };
+    }
+    for (int i = 0; i < 20; i += 2) {
+        list_append(dst, values + i);
+        list_append(src, values + i + 1);
+    }
+    list_append(src, &(data_t){ .val = 100 });
+
+    ck_assert(!list_merge_sorted(dst, src, compare_data));
+    ck_assert(list_is_empty(*src));
+    ck_assert(list_size(*dst) == 21);
+    for (int i = 0; i < 20; i++) {
+        ck_assert(list_get(*dst, i) == values + i);
+    }
+    ck_assert(((data_t *)list_get(*dst, 20))->val == 100);
+
+    ck_assert(!list_merge_sorted(src, dst, compare_data));
+    ck_assert(list_size(*src) == 21);
+    ck_assert(list_get(*src, 0) == values);
+
+    list_destroy(dst, nullptr);
+    list_destroy(src, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_HASH)
+{
+    list_t *list = list_create();
+    list_t *other = list_create();
+    data_t values[64];
+    list_val_t expected[512];
+    size_t size = 0;
+
+    for (int i = 0; i < 64; i++) {
+        values[i] = (data_t){ .val = i };
+    }
+
+    ck_assert(!list_append(list, values));
+    ck_assert(!list_append(list, values + 1));
+    size = 2;
+    expected[0] = values;
+    expected[1] = values + 1;
+    ck_assert(!list_hash_enable(list));
+    ck_assert(!list_hash_enable(other));
+
+    /* Mix every kind of change, checking every value after every step. */
+    for (int round = 0; round < 400; round++) {
+        int op = rand() % 10;
+        size_t idx = size > 0 ? rand() % size : 0;
+        list_val_t value = values + (rand() % 64);
+
+        if (op < 4 || size == 0) {
+            idx = rand() % (size + 1);
+            ck_assert(!list_insert(list, idx, value));
+            memmove(expected + idx + 1, expected + idx, (size - idx) * sizeof(list_val_t));
+            expected[idx] = value;
+            size++;
+        } else if (op < 5) {
+            ck_assert(list_set(list, idx, value) == expected[idx]);
+            expected[idx] = value;
+        } else if (op < 6) {
+            ssize_t found = -1;
+            for (size_t i = 0; i < size && found < 0; i++) {
+                if (expected[i] == value) {
+                    found = i;
+                }
+            }
+            ck_assert(list_remove(list, value) == found);
+            if (found >= 0) {
+                memmove(expected + found, expected + found + 1,
+                        (size - found - 1) * sizeof(list_val_t));
+                size--;
+            }
+        } else if (op < 7) {
+            /* Any copy of the value may go, so rebuild the expectation. */
+            bool present = list_contains(*list, value);
+            ck_assert(list_discard(list, value) == present);
+            size = 0;
+            for (list_cursor_t c = list_cursor_begin(list); list_cursor_valid(c);
+                 list_cursor_next(&c)) {
+                expected[size++] = list_cursor_get(c);
+            }
+        } else if (op < 8) {
+            /* Move a range out and back in through a second indexed list. */
+            size_t count = rand() % (size - idx + 1);
+            ck_assert(!list_splice(other, 0, list, idx, count));
+            for (size_t i = 0; i < count; i++) {
+                ck_assert(list_contains(*other, expected[idx + i]));
+            }
+            ck_assert(!list_splice(list, idx, other, 0, count));
+            ck_assert(list_is_empty(*other));
+        } else if (op < 9) {
+            list_sort(list, compare_data);
+            for (size_t i = 1; i < size; i++) {
+                for (size_t j = i; j > 0 && compare_data(expected[j - 1], expected[j]) > 0; j--) {
+                    list_val_t tmp = expected[j];
+                    expected[j] = expected[j - 1];
+                    expected[j - 1] = tmp;
+                }
+            }
+        } else {
+            list_cursor_t cursor = list_cursor_at(list, idx);
+            ck_assert(list_cursor_delete(&cursor) == expected[idx]);
+            memmove(expected + idx, expected + idx + 1, (size - idx - 1) * sizeof(list_val_t));
+            size--;
+        }
+
+        ck_assert(list_size(*list) == size);
+        for (size_t i = 0; i < size; i++) {
+            ck_assert(list_get(*list, i) == expected[i]);
+        }
+        for (int v = 0; v < 64; v++) {
+            ssize_t found = -1;
+            for (size_t i = 0; i < size && found < 0; i++) {
+                if (expected[i] == values + v) {
+                    found = i;
+                }
+            }
+            ck_assert(list_contains(*list, values + v) == (found >= 0));
+            ck_assert(list_find(*list, values + v) == found);
+        }
+    }
+
+    /* Emptying the list through the index leaves nothing behind. */
+    for (int v = 0; v < 64; v++) {
+        while (list_discard(list, values + v)) {
+        }
+    }
+    ck_assert(list_is_empty(*list));
+    ck_assert(!list_contains(*list, values));
+
+    list_hash_disable(list);
+    list_destroy(list, nullptr);
+    list_destroy(other, nullptr);
+}
+END_TEST
+
+typedef struct item {
+    int key;
+    double weight;
+} item_t;
+
+static int compare_items(list_val_t a, list_val_t b) {
+    return ((item_t *)a)->key - ((item_t *)b)->key;
+}
+
+START_TEST(LIST_INLINE)
+{
+    ck_assert(list_create_inline(0) == nullptr);
+
+    list_t *list = list_create_inline(sizeof(item_t));
+    list_t *pooled = list_create_inline_with_pool(sizeof(item_t), 4);
+    ck_assert(list);
+    ck_assert(pooled);
+    ck_assert(list_hash_enable(list));
+
+    /* Values are copied in, so the originals can change afterwards. */
+    item_t item = { .key = 0, .weight = 0.5 };
+    for (int i = 0; i < 10; i++) {
+        item.key = 9 - i;
+        ck_assert(!list_append(list, &item));
+        ck_assert(!list_append(pooled, &item));
+    }
+    item.key = 100;
+    ck_assert(((item_t *)list_get(*list, 0))->key == 9);
+    ck_assert(((item_t *)list_peek(*pooled))->key == 9);
+
+    /* Elements are found by their bytes. */
+    item.key = 4;
+    ck_assert(list_find(*list, &item) == 5);
+    ck_assert(list_contains(*pooled, &item));
+    ck_assert(list_remove(pooled, &item) == 5);
+    ck_assert(!list_contains(*pooled, &item));
+
+    item_t out;
+    ck_assert(!list_get_into(*list, 9, &out));
+    ck_assert(out.key == 0 && out.weight == 0.5);
+    ck_assert(list_get_into(*list, 10, &out));
+    ck_assert(!list_delete_into(list, 0, &out));
+    ck_assert(out.key == 9);
+    ck_assert(list_delete(list, 0) == nullptr);
+    ck_assert(list_size(*list) == 8);
+
+    item.key = 42;
+    item_t *stored = list_set(list, 0, &item);
+    ck_assert(stored->key == 42);
+    ck_assert(((item_t *)list_get(*list, 0))->key == 42);
+
+    /* A nullptr value stands for all zero bytes. */
+    ck_assert(!list_prepend(list, nullptr));
+    ck_assert(((item_t *)list_get(*list, 0))->key == 0);
+    ck_assert(list_find(*list, nullptr) == 0);
+
+    list_sort(pooled, compare_items);
+    for (size_t i = 0; i + 1 < list_size(*pooled); i++) {
+        ck_assert(compare_items(list_get(*pooled, i), list_get(*pooled, i + 1)) < 0);
+    }
+
+    /* Elements only move between lists with the same element size. */
+    list_t *plain = list_create();
+    ck_assert(list_concat(plain, list));
+    ck_assert(list_concat(list, plain));
+    list_destroy(plain, nullptr);
+
+    list_t *rest = list_split(pooled, 4);
+    ck_assert(rest);
+    ck_assert(list_size(*rest) == 5);
+    ck_assert(((item_t *)list_get(*rest, 0))->key == 5);
+    ck_assert(!list_concat(list, rest));
+    ck_assert(list_size(*list) == 14);
+    ck_assert(((item_t *)list_get(*list, 9))->key == 5);
+    list_destroy(rest, nullptr);
+
+    destroy_count = 0;
+    list_destroy(list, destroy_counter);
+    ck_assert(destroy_count == 14);
+    destroy_count = 0;
+    list_destroy(pooled, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_FIND_BY)
+{
+    list_t *list = list_create();
+    data_t values[100];
+    for (int i = 0; i < 100; i++) {
+        /* Every value appears twice, so the first match must be found. */
+        values[i] = (data_t){ .val = i % 50 };
+        list_append(list, values + i);
+    }
+
+    for (int i = 0; i < 50; i++) {
+        data_t key = { .val = i };
+        ck_assert(list_find_by(*list, &key, compare_data) == i);
+    }
+    data_t missing = { .val = 50 };
+    ck_assert(list_find_by(*list, &missing, compare_data) == -1);
+    list_destroy(list, nullptr);
+
+    list = list_create();
+    ck_assert(list_find_by(*list, &missing, compare_data) == -1);
+    list_destroy(list, nullptr);
+
+    /* Inline values are passed to the comparator as pointers into the nodes. */
+    list = list_create_inline(sizeof(item_t));
+    for (int i = 0; i < 40; i++) {
+        item_t item = { .key = i, .weight = i / 2.0 };
+        list_prepend(list, &item);
+    }
+    item_t key = { .key = 7 };
+    ck_assert(list_find_by(*list, &key, compare_items) == 32);
+    list_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(LIST_STATS)
+{
+    list_t *list = list_create();
+    struct list_stats stats;
+    data_t values[200];
+
+    for (int i = 0; i < 200; i++) {
+        values[i] = (data_t){ .val = i };
+        list_append(list, values + i);
+    }
+    list_get(*list, 100);
+    list_find(*list, values + 150);
+    list_delete(list, 0);
+
+    /* Without XORLIST_STATS, there is nothing to report. */
+    if (list_stats(list, &stats)) {
+        ck_assert(stats.inserts == 0 && stats.lookups == 0 && stats.bytes == 0);
+        list_destroy(list, nullptr);
+        return;
+    }
+
+    ck_assert(stats.inserts == 200);
+    ck_assert(stats.removes == 1);
+    ck_assert(stats.allocs == 200);
+    ck_assert(stats.frees == 1);
+    ck_assert(stats.searches == 1);
+    ck_assert(stats.lookups == 2);
+    ck_assert(stats.max_steps == 150);
+    ck_assert(stats.steps == 250);
+    ck_assert(stats.long_walks == 2);
+    ck_assert(stats.bytes == 199 * sizeof(node_t));
+
+    list_stats_reset(list);
+    ck_assert(!list_stats(list, &stats));
+    ck_assert(stats.inserts == 0 && stats.steps == 0);
+    ck_assert(stats.bytes == 199 * sizeof(node_t));
+
+    list_destroy(list, nullptr);
+}
+END_TEST
+
 
 void tests (Suite *s) {
     TCase *tests = tcase_create("tests");
     tcase_add_test(tests, LIST_CREATE);
+    tcase_add_test(tests, LIST_INIT);
+    tcase_add_test(tests, LIST_CREATE_WITH_POOL);
+    tcase_add_test(tests, LIST_POOL_REUSE);
     tcase_add_test(tests, LIST_DESTROY);
     tcase_add_test(tests, LIST_DESTROY_FREE);
+    tcase_add_test(tests, LIST_DESTROY_ORDER);
+    tcase_add_test(tests, LIST_DESTROY_ASYNC);
     tcase_add_test(tests, LIST_INSERT);
     tcase_add_test(tests, LIST_INSERT_INDEX);
     tcase_add_test(tests, LIST_APPEND);
     tcase_add_test(tests, LIST_ENQUEUE);
     tcase_add_test(tests, LIST_PREPEND);
     tcase_add_test(tests, LIST_PUSH);
+    tcase_add_test(tests, LIST_INSERT_MANY);
+    tcase_add_test(tests, LIST_ARRAY);
+    tcase_add_test(tests, LIST_COMPACT);
+    tcase_add_test(tests, LIST_COMPACT_AUTO);
     tcase_add_test(tests, LIST_EMPTY);
     tcase_add_test(tests, LIST_DELETE);
     tcase_add_test(tests, LIST_GET);
@@ -430,10 +1605,26 @@ void tests (Suite *s) {
     tcase_add_test(tests, LIST_SET);
     tcase_add_test(tests, LIST_SIZE);
     tcase_add_test(tests, LIST_REMOVE);
+    tcase_add_test(tests, LIST_REMOVE_IF);
     tcase_add_test(tests, LIST_POP);
     tcase_add_test(tests, LIST_DEQUEUE);
     tcase_add_test(tests, LIST_FIND);
     tcase_add_test(tests, LIST_CONTAINS);
     tcase_add_test(tests, LIST_REVERSE);
+    tcase_add_test(tests, LIST_INSERT_END);
+    tcase_add_test(tests, LIST_CURSOR_TRAVERSE);
+    tcase_add_test(tests, LIST_CURSOR_MODIFY);
+    tcase_add_test(tests, LIST_ANCHORS);
+    tcase_add_test(tests, LIST_CONCAT);
+    tcase_add_test(tests, LIST_SPLICE);
+    tcase_add_test(tests, LIST_SPLICE_POOLS);
+    tcase_add_test(tests, LIST_SPLIT);
+    tcase_add_test(tests, LIST_SORT);
+    tcase_add_test(tests, LIST_INSERT_SORTED);
+    tcase_add_test(tests, LIST_MERGE_SORTED);
+    tcase_add_test(tests, LIST_HASH);
+    tcase_add_test(tests, LIST_INLINE);
+    tcase_add_test(tests, LIST_FIND_BY);
+    tcase_add_test(tests, LIST_STATS);
     suite_add_tcase(s, tests);
 }
@@ -8,10 +8,30 @@
 #include <check.h>
 
 extern void tests (Suite *s);
+extern void ulist_tests (Suite *s);
+extern void lru_tests (Suite *s);
+extern void cqueue_tests (Suite *s);
+extern void bqueue_tests (Suite *s);
+extern void gen_tests (Suite *s);
+extern void ilist_tests (Suite *s);
+extern void persist_tests (Suite *s);
+extern void parallel_tests (Suite *s);
+extern void alist_tests (Suite *s);
+extern void snapshot_tests (Suite *s);
 
 Suite * test_suite (void) {
     Suite *s = suite_create("Default");
     tests(s);
+    ulist_tests(s);
+    lru_tests(s);
+    cqueue_tests(s);
+    bqueue_tests(s);
+    gen_tests(s);
+    ilist_tests(s);
+    persist_tests(s);
+    parallel_tests(s);
+    alist_tests(s);
+    snapshot_tests(s);
     return s;
 }
 
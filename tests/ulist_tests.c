@@ -0,0 +1,208 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <check.h>
+
+#include "list.h"
+#include "ulist.h"
+
+typedef struct data {
+    int val;
+} data_t;
+
+static int destroy_count = 0;
+static void destroy_counter(list_val_t _) {
+    destroy_count += 1;
+}
+
+START_TEST(ULIST_CREATE)
+{
+    ulist_t *list = ulist_create();
+    ck_assert(list);
+    ck_assert(ulist_is_empty(*list));
+    ck_assert(ulist_peek(*list) == nullptr);
+    ulist_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(ULIST_DESTROY)
+{
+    ulist_t *list = ulist_create();
+
+    size_t items = 100;
+    for (size_t i = 0; i < items; i++) ulist_append(list, nullptr);
+
+    destroy_count = 0;
+    ulist_destroy(list, destroy_counter);
+    ck_assert(destroy_count == items);
+    destroy_count = 0;
+}
+END_TEST
+
+START_TEST(ULIST_APPEND_PREPEND)
+{
+    ulist_t *list = ulist_create();
+    data_t values[100];
+
+    for (int i = 0; i < 100; i++) {
+        values[i] = (data_t){ .val = i };
+    }
+    for (int i = 50; i < 100; i++) {
+        ck_assert(!ulist_append(list, values + i));
+    }
+    for (int i = 49; i >= 0; i--) {
+        ck_assert(!ulist_prepend(list, values + i));
+    }
+
+    ck_assert(ulist_size(*list) == 100);
+    for (int i = 0; i < 100; i++) {
+        ck_assert(ulist_get(*list, i) == values + i);
+        ck_assert(ulist_find(*list, values + i) == i);
+    }
+
+    ulist_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(ULIST_INSERT_DELETE)
+{
+    ulist_t *list = ulist_create();
+    data_t values[200];
+    for (int i = 0; i < 200; i++) {
+        values[i] = (data_t){ .val = i };
+    }
+
+    /* Build 0..199 by always inserting into the middle of a chunk. */
+    ck_assert(!ulist_append(list, values + 0));
+    ck_assert(!ulist_append(list, values + 199));
+    for (int i = 1; i < 199; i++) {
+        ck_assert(!ulist_insert(list, i, values + i));
+    }
+    ck_assert(ulist_insert(list, 201, values));
+
+    for (int i = 0; i < 200; i++) {
+        ck_assert(ulist_get(*list, i) == values + i);
+    }
+
+    /* Remove every odd value, then the rest from the back. */
+    for (int i = 0; i < 100; i++) {
+        ck_assert(ulist_delete(list, i + 1) == values + (2 * i + 1));
+    }
+    for (int i = 0; i < 100; i++) {
+        ck_assert(ulist_get(*list, i) == values + 2 * i);
+    }
+    for (int i = 99; i >= 0; i--) {
+        ck_assert(ulist_delete(list, i) == values + 2 * i);
+    }
+    ck_assert(ulist_is_empty(*list));
+    ck_assert(ulist_delete(list, 0) == nullptr);
+
+    ulist_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(ULIST_QUEUE_STACK)
+{
+    ulist_t *list = ulist_create();
+    data_t values[50];
+
+    for (int i = 0; i < 50; i++) {
+        values[i] = (data_t){ .val = i };
+        ulist_enqueue(list, values + i);
+    }
+    for (int i = 0; i < 50; i++) {
+        ck_assert(ulist_peek(*list) == values + i);
+        ck_assert(ulist_dequeue(list) == values + i);
+    }
+
+    for (int i = 0; i < 50; i++) {
+        ulist_push(list, values + i);
+    }
+    for (int i = 49; i >= 0; i--) {
+        ck_assert(ulist_pop(list) == values + i);
+    }
+
+    ulist_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(ULIST_SET_REMOVE_CONTAINS)
+{
+    ulist_t *list = ulist_create();
+    data_t values[60];
+    for (int i = 0; i < 60; i++) {
+        values[i] = (data_t){ .val = i };
+    }
+    for (int i = 0; i < 30; i++) {
+        ulist_append(list, values + i);
+    }
+
+    for (int i = 0; i < 30; i++) {
+        ck_assert(ulist_set(list, i, values + 30 + i) == values + i);
+    }
+    ck_assert(ulist_set(list, 30, values) == nullptr);
+
+    ck_assert(!ulist_contains(*list, values + 5));
+    ck_assert(ulist_contains(*list, values + 35));
+    ck_assert(ulist_remove(list, values + 5) == -1);
+    ck_assert(ulist_remove(list, values + 45) == 15);
+    ck_assert(ulist_find(*list, values + 46) == 15);
+    ck_assert(ulist_size(*list) == 29);
+
+    ulist_destroy(list, nullptr);
+}
+END_TEST
+
+START_TEST(ULIST_REVERSE)
+{
+    ulist_t *list = ulist_create();
+    list_t *reference = list_create();
+    data_t values[100];
+
+    for (int i = 0; i < 100; i++) {
+        values[i] = (data_t){ .val = i };
+        ulist_append(list, values + i);
+        list_append(reference, values + i);
+    }
+
+    /* Keep mutating both lists while flipping them back and forth. */
+    for (int round = 0; round < 200; round++) {
+        if (round % 7 == 0) {
+            ulist_reverse(list);
+            list_reverse(reference);
+        }
+        size_t idx = (round * 31) % (list_size(*reference) + 1);
+        if (round % 3 == 0 && list_size(*reference) > 0) {
+            idx %= list_size(*reference);
+            ck_assert(ulist_delete(list, idx) == list_delete(reference, idx));
+        } else {
+            list_val_t value = values + (round % 100);
+            ck_assert(!ulist_insert(list, idx, value));
+            ck_assert(!list_insert(reference, idx, value));
+        }
+
+        ck_assert(ulist_size(*list) == list_size(*reference));
+        list_cursor_t cursor = list_cursor_begin(reference);
+        for (size_t i = 0; list_cursor_valid(cursor); i++, list_cursor_next(&cursor)) {
+            ck_assert(ulist_get(*list, i) == list_cursor_get(cursor));
+        }
+    }
+
+    ulist_destroy(list, nullptr);
+    list_destroy(reference, nullptr);
+}
+END_TEST
+
+
+void ulist_tests (Suite *s) {
+    TCase *tests = tcase_create("ulist");
+    tcase_add_test(tests, ULIST_CREATE);
+    tcase_add_test(tests, ULIST_DESTROY);
+    tcase_add_test(tests, ULIST_APPEND_PREPEND);
+    tcase_add_test(tests, ULIST_INSERT_DELETE);
+    tcase_add_test(tests, ULIST_QUEUE_STACK);
+    tcase_add_test(tests, ULIST_SET_REMOVE_CONTAINS);
+    tcase_add_test(tests, ULIST_REVERSE);
+    suite_add_tcase(s, tests);
+}